@@ -0,0 +1,228 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AssetBundle.h"
+
+const char AssetBundle::MAGIC[4] = {'K', 'P', 'A', 'K'};
+
+AssetBundle::AssetBundle()
+	: _data(NULL)
+	, _size(0)
+{
+}
+
+AssetBundle::~AssetBundle()
+{
+	close();
+}
+
+QString AssetBundle::getDefaultPath()
+{
+	return QCoreApplication::applicationDirPath() + "/Kinetris.pak";
+}
+
+bool AssetBundle::open(const QString& path)
+{
+	close();
+
+	_file.setFileName(path);
+	if (!_file.open(QIODevice::ReadOnly))
+		return false;
+
+	_size = _file.size();
+	_data = _file.map(0, _size);
+	if ((!_data) || (_size < static_cast<qint64>(sizeof(Header))))
+	{
+		close();
+		return false;
+	}
+
+	const Header* header = reinterpret_cast<const Header*>(_data);
+	if ((memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0)
+		|| (header->version != VERSION)
+		|| (header->count > (_size - sizeof(Header)) / sizeof(Entry)))
+	{
+		qWarning("AssetBundle: %s is not a version %d bundle", qPrintable(path), VERSION);
+		close();
+		return false;
+	}
+
+	QStringList uris;
+
+	const Entry* entry = reinterpret_cast<const Entry*>(_data + sizeof(Header));
+	for (quint32 i = 0; i < header->count; ++i, ++entry)
+	{
+		if ((entry->offset > static_cast<quint64>(_size))
+			|| (entry->size > static_cast<quint64>(_size) - entry->offset))
+		{
+			qWarning("AssetBundle: %s is truncated", qPrintable(path));
+			close();
+			return false;
+		}
+
+		// getImage hands these straight to QImage, so the pixels must fit the entry
+		if ((entry->format != QImage::Format_ARGB32_Premultiplied)
+			|| (entry->width == 0)
+			|| (entry->height == 0)
+			|| (entry->offset % ALIGNMENT != 0)
+			|| (entry->bytesPerLine % 4 != 0)
+			|| (entry->bytesPerLine < static_cast<quint64>(entry->width) * 4)
+			|| (static_cast<quint64>(entry->bytesPerLine) * entry->height > entry->size))
+		{
+			qWarning("AssetBundle: %s has a corrupt entry", qPrintable(path));
+			close();
+			return false;
+		}
+
+		uris << QString::fromLatin1(entry->uri, qstrnlen(entry->uri, sizeof(entry->uri)));
+		_entries.insert(uris.last(), entry);
+	}
+
+	// The URIs name the same PNGs in the resources, so a changed image shows up here
+	if (getStamp(uris) != header->stamp)
+	{
+		qWarning("AssetBundle: %s is older than its images, pack it again", qPrintable(path));
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+void AssetBundle::close()
+{
+	_entries.clear();
+
+	if (_data)
+	{
+		_file.unmap(_data);
+		_data = NULL;
+	}
+	_size = 0;
+
+	_file.close();
+}
+
+bool AssetBundle::isOpen() const
+{
+	return _data != NULL;
+}
+
+bool AssetBundle::contains(const QString& uri) const
+{
+	return _entries.contains(uri);
+}
+
+QImage AssetBundle::getImage(const QString& uri) const
+{
+	const Entry* entry = _entries.value(uri, NULL);
+	if (!entry)
+		return QImage();
+
+	// Read-only constructor; the pixels stay in the mapping until something writes to the image
+	return QImage(static_cast<const uchar*>(_data + entry->offset), entry->width, entry->height,
+		entry->bytesPerLine, static_cast<QImage::Format>(entry->format));
+}
+
+bool AssetBundle::isMapped(const QImage& image) const
+{
+	const uchar* bits = image.constBits();
+
+	return ((_data)
+		&& (bits >= _data)
+		&& (bits < _data + _size));
+}
+
+quint32 AssetBundle::getStamp(const QStringList& files)
+{
+	QCryptographicHash hash(QCryptographicHash::Md5);
+	foreach (const QString& name, files)
+	{
+		QFile file(name);
+		if (!file.open(QIODevice::ReadOnly))
+			return 0;
+
+		hash.addData(file.readAll());
+	}
+
+	quint32 stamp;
+	memcpy(&stamp, hash.result().constData(), sizeof(stamp));
+
+	return stamp;
+}
+
+bool AssetBundle::write(const QString& path, const QList<QPair<QString, QImage> >& images, quint32 stamp)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return false;
+
+	Header header;
+	memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = VERSION;
+	header.count = images.count();
+	header.stamp = stamp;
+
+	QVector<Entry> entries(images.count());
+	QVector<QImage> converted;
+	converted.reserve(images.count());
+
+	quint64 offset = sizeof(Header) + (sizeof(Entry) * images.count());
+	for (int i = 0, il = images.count(); i < il; ++i)
+	{
+		const QString& uri = images[i].first;
+		if (uri.length() >= static_cast<int>(sizeof(entries[i].uri)))
+		{
+			qWarning("AssetBundle: %s is too long", qPrintable(uri));
+			return false;
+		}
+
+		// What the raster and GL paint engines upload without conversion
+		QImage image = images[i].second.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+		offset = (offset + (ALIGNMENT - 1)) & ~static_cast<quint64>(ALIGNMENT - 1);
+
+		Entry& entry = entries[i];
+		memset(entry.uri, 0, sizeof(entry.uri));
+		memcpy(entry.uri, uri.toLatin1().constData(), uri.length());
+		entry.width = image.width();
+		entry.height = image.height();
+		entry.bytesPerLine = image.bytesPerLine();
+		entry.format = image.format();
+		entry.offset = offset;
+		entry.size = image.byteCount();
+
+		offset += entry.size;
+
+		converted << image;
+	}
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(entries.constData()), sizeof(Entry) * entries.count());
+
+	static const char padding[ALIGNMENT] = {0};
+	for (int i = 0, il = converted.count(); i < il; ++i)
+	{
+		file.write(padding, entries[i].offset - file.pos());
+		file.write(reinterpret_cast<const char*>(converted[i].constBits()), entries[i].size);
+	}
+
+	return file.error() == QFile::NoError;
+}
@@ -0,0 +1,80 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KINETRIS_ASSETBUNDLE_H
+#define KINETRIS_ASSETBUNDLE_H
+
+#include <QtGui/QtGui>
+
+class AssetBundle
+{
+public:
+
+	AssetBundle();
+	virtual ~AssetBundle();
+
+	static QString getDefaultPath();
+
+	bool open(const QString& path);
+	void close();
+
+	bool isOpen() const;
+
+	bool contains(const QString& uri) const;
+	QImage getImage(const QString& uri) const; // shares the mapped memory
+	bool isMapped(const QImage& image) const; // still reads from the mapping
+
+	static quint32 getStamp(const QStringList& files); // of the source files' contents
+	static bool write(const QString& path, const QList<QPair<QString, QImage> >& images, quint32 stamp);
+
+protected:
+
+	static const char MAGIC[4];
+	static const quint32 VERSION = 2;
+	static const int ALIGNMENT = 16; // bytes
+
+	// On-disk layout, in host byte order so pixel rows can be used in place
+	struct Header
+	{
+		char magic[4];
+		quint32 version;
+		quint32 count;
+		quint32 stamp; // getStamp of the images it was packed from
+	};
+
+	struct Entry
+	{
+		char uri[64];
+		quint32 width;
+		quint32 height;
+		quint32 bytesPerLine;
+		quint32 format; // QImage::Format
+		quint64 offset; // bytes from start of file
+		quint64 size; // bytes
+	};
+
+	QFile _file;
+	uchar* _data;
+	qint64 _size;
+
+	QHash<QString, const Entry*> _entries;
+};
+
+#endif // KINETRIS_ASSETBUNDLE_H
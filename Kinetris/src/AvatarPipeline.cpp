@@ -0,0 +1,224 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AvatarPipeline.h"
+
+const int AvatarPipeline::BAND_ROWS = 16; // rows, minimum
+
+AvatarPipeline::Band::Band(AvatarPipeline* pipeline, int y0, int y1)
+	: QRunnable()
+{
+	_pipeline = pipeline;
+	_y0 = y0;
+	_y1 = y1;
+}
+
+void AvatarPipeline::Band::run()
+{
+	_pipeline->convertBand(_y0, _y1);
+	_pipeline->finishBand();
+}
+
+AvatarPipeline::AvatarPipeline(QObject* parent)
+	: QObject(parent)
+{
+	init();
+}
+
+AvatarPipeline::~AvatarPipeline()
+{
+	// Wait for bands still converting
+	_pool->waitForDone();
+}
+
+void AvatarPipeline::init()
+{
+	// Leave a core for the capture thread, keep workers around between frames
+	_pool = new QThreadPool(this);
+	_pool->setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+	_pool->setExpiryTimeout(-1);
+
+	_busy = 0;
+	_remaining = 0;
+
+	_rgb = false;
+	_span = 0;
+	_shift = 0;
+
+	_bits = NULL;
+	_bytesPerLine = 0;
+}
+
+bool AvatarPipeline::isBusy() const
+{
+	return (_busy.fetchAndAddAcquire(0) != 0);
+}
+
+bool AvatarPipeline::convert(const XnDepthPixel* src, const XnLabel* usr, int xres,
+	const QVector<int>& rows, const QVector<int>& cols,
+	const QVector<QRgb>& lookup, int shift,
+	const QRect& rect, const QSize& size)
+{
+	if (!begin(cols, rect, size))
+		return false;
+
+	_rgb = false;
+	_lookup = lookup;
+	_shift = shift;
+
+	// Only the rows and columns that are sampled
+	int yl = rect.height();
+	_depthRows.resize(yl * _span);
+	_labelRows.resize(yl * _span);
+
+	for (int y = 0; y < yl; ++y)
+	{
+		int i = (rows[y] * xres) + cols.first();
+
+		memcpy(_depthRows.data() + (y * _span), src + i, _span * sizeof(XnDepthPixel));
+		memcpy(_labelRows.data() + (y * _span), usr + i, _span * sizeof(XnLabel));
+	}
+
+	start();
+	return true;
+}
+
+bool AvatarPipeline::convert(const XnRGB24Pixel* src, const XnLabel* usr, int xres,
+	const QVector<int>& rows, const QVector<int>& cols,
+	const QRect& rect, const QSize& size)
+{
+	if (!begin(cols, rect, size))
+		return false;
+
+	_rgb = true;
+
+	// Only the rows and columns that are sampled
+	int yl = rect.height();
+	_imageRows.resize(yl * _span);
+	_labelRows.resize(yl * _span);
+
+	for (int y = 0; y < yl; ++y)
+	{
+		int i = (rows[y] * xres) + cols.first();
+
+		memcpy(_imageRows.data() + (y * _span), src + i, _span * sizeof(XnRGB24Pixel));
+		memcpy(_labelRows.data() + (y * _span), usr + i, _span * sizeof(XnLabel));
+	}
+
+	start();
+	return true;
+}
+
+bool AvatarPipeline::begin(const QVector<int>& cols, const QRect& rect, const QSize& size)
+{
+	// Drop the frame if still busy with the previous one
+	if (!_busy.testAndSetAcquire(0, 1))
+		return false;
+
+	_span = cols.last() - cols.first() + 1;
+
+	_cols.resize(cols.count());
+	for (int x = 0, xl = cols.count(); x < xl; ++x)
+	{
+		_cols[x] = cols[x] - cols.first();
+	}
+
+	// Workers write straight into the scan lines, each to their own
+	_usersMap = QImage(rect.size(), QImage::Format_ARGB32_Premultiplied);
+	_bits = _usersMap.bits();
+	_bytesPerLine = _usersMap.bytesPerLine();
+	_offset = rect.topLeft();
+	_size = size;
+
+	return true;
+}
+
+void AvatarPipeline::start()
+{
+	int rows = _usersMap.height();
+	int bands = qMax(1, qMin(_pool->maxThreadCount(), rows / BAND_ROWS));
+
+	_remaining = bands;
+
+	for (int i = 0; i < bands; ++i)
+	{
+		_pool->start(new Band(this, (rows * i) / bands, (rows * (i + 1)) / bands));
+	}
+}
+
+void AvatarPipeline::convertBand(int y0, int y1)
+{
+	const int* cols = _cols.constData();
+	int xl = _cols.count();
+
+	for (int y = y0; y < y1; ++y)
+	{
+		const XnLabel* usrRow = _labelRows.constData() + (y * _span);
+		QRgb* dst = reinterpret_cast<QRgb*>(_bits + (y * _bytesPerLine));
+
+		// Copy pixels occupied by users, set unoccupied pixels to transparent
+		if (_rgb)
+		{
+			const XnRGB24Pixel* srcRow = _imageRows.constData() + (y * _span);
+
+			for (int x = 0; x < xl; ++x)
+			{
+				int i = cols[x];
+
+				*dst = (usrRow[i])
+					? qRgba(srcRow[i].nRed, srcRow[i].nGreen, srcRow[i].nBlue, 0xFF)
+					: 0x00000000;
+
+				++dst;
+			}
+		}
+		else
+		{
+			const XnDepthPixel* srcRow = _depthRows.constData() + (y * _span);
+			const QRgb* lookup = _lookup.constData();
+
+			for (int x = 0; x < xl; ++x)
+			{
+				int i = cols[x];
+
+				*dst = (usrRow[i])
+					? lookup[srcRow[i] >> _shift]
+					: 0x00000000;
+
+				++dst;
+			}
+		}
+	}
+}
+
+void AvatarPipeline::finishBand()
+{
+	// Last band to finish hands over the image
+	if (_remaining.fetchAndAddOrdered(-1) != 1)
+		return;
+
+	QImage usersMap = _usersMap;
+	_usersMap = QImage();
+	_bits = NULL;
+
+	emit evUsersMap(usersMap, _offset, _size);
+
+	_busy.fetchAndStoreRelease(0);
+}
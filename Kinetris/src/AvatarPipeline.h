@@ -0,0 +1,103 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KINETRIS_AVATARPIPELINE_H
+#define KINETRIS_AVATARPIPELINE_H
+
+#include <QtGui/QtGui>
+
+#include <XnOpenNI.h>
+
+// Converts the users' pixels of a sensor frame into the avatar image, in row
+// bands on a small pool of worker threads; takes a snapshot of the rows it
+// needs, so the capture thread can go back to waiting for the next frame
+// while the workers finish; frames that arrive while busy are dropped
+class AvatarPipeline : public QObject
+{
+	Q_OBJECT
+
+signals:
+
+	void evUsersMap(QImage image, QPoint offset, QSize size);
+
+public:
+
+	AvatarPipeline(QObject* parent);
+	virtual ~AvatarPipeline();
+
+	bool isBusy() const;
+
+	bool convert(const XnDepthPixel* src, const XnLabel* usr, int xres,
+		const QVector<int>& rows, const QVector<int>& cols,
+		const QVector<QRgb>& lookup, int shift,
+		const QRect& rect, const QSize& size);
+	bool convert(const XnRGB24Pixel* src, const XnLabel* usr, int xres,
+		const QVector<int>& rows, const QVector<int>& cols,
+		const QRect& rect, const QSize& size);
+
+protected:
+
+	class Band : public QRunnable
+	{
+	public:
+
+		Band(AvatarPipeline* pipeline, int y0, int y1);
+
+		void run();
+
+	protected:
+
+		AvatarPipeline* _pipeline;
+		int _y0;
+		int _y1;
+	};
+
+	static const int BAND_ROWS; // rows, minimum
+
+	QThreadPool* _pool;
+
+	mutable QAtomicInt _busy;
+	QAtomicInt _remaining;
+
+	bool _rgb;
+	int _span; // px
+	QVector<int> _cols;
+	QVector<XnDepthPixel> _depthRows;
+	QVector<XnRGB24Pixel> _imageRows;
+	QVector<XnLabel> _labelRows;
+	QVector<QRgb> _lookup;
+	int _shift;
+
+	QImage _usersMap;
+	uchar* _bits;
+	int _bytesPerLine;
+	QPoint _offset;
+	QSize _size;
+
+	void init();
+
+	bool begin(const QVector<int>& cols, const QRect& rect, const QSize& size);
+	void start();
+
+	void convertBand(int y0, int y1);
+	void finishBand();
+};
+
+#endif // KINETRIS_AVATARPIPELINE_H
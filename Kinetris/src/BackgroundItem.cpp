@@ -0,0 +1,289 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BackgroundItem.h"
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+#ifndef GL_TEXTURE0
+#define GL_TEXTURE0 0x84C0
+#endif
+
+typedef void (APIENTRY* ActiveTextureProc)(GLenum texture);
+
+const char* BackgroundItem::VERTEX_SHADER =
+	"attribute highp vec4 vertex;\n"
+	"uniform highp mat4 matrix;\n"
+	"varying highp vec2 position;\n"
+	"void main()\n"
+	"{\n"
+	"	position = vertex.xy;\n"
+	"	gl_Position = matrix * vertex;\n"
+	"}\n";
+
+// Textures are premultiplied; each layer goes "over" the ones below it
+const char* BackgroundItem::FRAGMENT_SHADER =
+	"uniform sampler2D noise;\n"
+	"uniform sampler2D fence;\n"
+	"uniform sampler2D coverBg;\n"
+	"uniform sampler2D coverFg;\n"
+	"uniform highp vec2 noiseSize;\n"
+	"uniform highp vec2 fenceSize;\n"
+	"uniform highp vec2 coverBgSize;\n"
+	"uniform highp vec2 coverFgSize;\n"
+	"uniform highp vec2 noiseOrigin0;\n"
+	"uniform highp vec2 noiseOrigin1;\n"
+	"uniform highp vec2 fenceOrigin;\n"
+	"uniform lowp vec4 color;\n"
+	"uniform lowp float fade;\n"
+	"uniform lowp float opacity;\n"
+	"varying highp vec2 position;\n"
+	"lowp vec4 tile(sampler2D tex, highp vec2 origin, highp vec2 size)\n"
+	"{\n"
+	"	highp vec2 t = fract((position - origin) / size);\n"
+	"	return texture2D(tex, vec2(t.x, 1.0 - t.y));\n"
+	"}\n"
+	"lowp vec3 over(lowp vec4 src, lowp vec3 dst)\n"
+	"{\n"
+	"	return src.rgb + (dst * (1.0 - src.a));\n"
+	"}\n"
+	"void main()\n"
+	"{\n"
+	"	lowp vec3 c = mix(over(tile(noise, noiseOrigin0, noiseSize), color.rgb),\n"
+	"		over(tile(noise, noiseOrigin1, noiseSize), color.rgb), fade);\n"
+	"	c = over(tile(fence, fenceOrigin, fenceSize), c);\n"
+	"	c = over(tile(coverBg, vec2(0.0), coverBgSize), c);\n"
+	"	c = over(tile(coverFg, vec2(0.0), coverFgSize), c);\n"
+	"	gl_FragColor = vec4(c, 1.0) * opacity;\n"
+	"}\n";
+
+BackgroundItem::BackgroundItem(const QSizeF& size, QGraphicsItem* parent)
+	: QGraphicsItem(parent)
+	, _size(size)
+	, _fade(0.0f)
+	, _program(NULL)
+	, _shaded(true)
+{
+	setFlags(QGraphicsItem::ItemUsesExtendedStyleOption);
+}
+
+BackgroundItem::~BackgroundItem()
+{
+	delete _program;
+}
+
+void BackgroundItem::setColor(const QColor& color)
+{
+	_color = color;
+
+	update();
+}
+
+void BackgroundItem::setNoise(const QPixmap& pixmap)
+{
+	_noise = pixmap;
+
+	update();
+}
+
+void BackgroundItem::setFence(const QPixmap& pixmap, const QPointF& origin)
+{
+	_fence = pixmap;
+	_fenceOrigin = origin;
+
+	update();
+}
+
+void BackgroundItem::setCover(const QPixmap& bg, const QPixmap& fg)
+{
+	_coverBg = bg;
+	_coverFg = fg;
+
+	update();
+}
+
+void BackgroundItem::setScroll(const QPointF& origin0, const QPointF& origin1, qreal fade)
+{
+	_noiseOrigin[0] = origin0;
+	_noiseOrigin[1] = origin1;
+	_fade = fade;
+
+	update();
+}
+
+QRectF BackgroundItem::boundingRect() const
+{
+	return QRectF(QPointF(0.0f, 0.0f), _size);
+}
+
+void BackgroundItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+	// Prevent "unreferenced formal parameter" warning
+	widget;
+
+	QRectF exposed = option->exposedRect & boundingRect();
+	if (exposed.isEmpty())
+		return;
+
+	if (!paintShaded(painter, exposed))
+	{
+		paintLayers(painter, exposed);
+	}
+}
+
+bool BackgroundItem::initProgram()
+{
+	if (_program)
+		return true;
+
+	if (!QGLShaderProgram::hasOpenGLShaderPrograms())
+		return false;
+
+	_program = new QGLShaderProgram();
+	if (!((_program->addShaderFromSourceCode(QGLShader::Vertex, VERTEX_SHADER))
+		&& (_program->addShaderFromSourceCode(QGLShader::Fragment, FRAGMENT_SHADER))
+		&& (_program->link())))
+	{
+		qWarning() << "Background shader unavailable:" << _program->log();
+
+		delete _program;
+		_program = NULL;
+		return false;
+	}
+
+	return true;
+}
+
+bool BackgroundItem::paintShaded(QPainter* painter, const QRectF& exposed)
+{
+	if (!_shaded)
+		return false;
+
+	if ((_noise.isNull())
+		|| (_fence.isNull())
+		|| (_coverBg.isNull())
+		|| (_coverFg.isNull()))
+	{
+		return false;
+	}
+
+	const QGLContext* context = QGLContext::currentContext();
+	if (!((painter->paintEngine()->type() == QPaintEngine::OpenGL2)
+		&& (context)))
+	{
+		return false;
+	}
+
+	ActiveTextureProc activeTexture = reinterpret_cast<ActiveTextureProc>(
+		const_cast<QGLContext*>(context)->getProcAddress("glActiveTexture"));
+	if (!((activeTexture)
+		&& (initProgram())))
+	{
+		_shaded = false;
+		return false;
+	}
+
+	// Item space to normalized device coordinates
+	QMatrix4x4 matrix;
+	matrix.ortho(0.0f, painter->device()->width(), painter->device()->height(), 0.0f, -1.0f, 1.0f);
+	matrix *= QMatrix4x4(painter->deviceTransform());
+
+	QVector2D vertices[] = {
+		QVector2D(exposed.topLeft()),
+		QVector2D(exposed.topRight()),
+		QVector2D(exposed.bottomRight()),
+		QVector2D(exposed.bottomLeft())
+	};
+
+	// No mipmaps: the shader wraps coordinates itself, which would otherwise pick tiny levels at the seams
+	QGLContext::BindOptions options = QGLContext::LinearFilteringBindOption
+		| QGLContext::InvertedYBindOption
+		| QGLContext::PremultipliedAlphaBindOption;
+
+	const QPixmap* textures[] = {&_noise, &_fence, &_coverBg, &_coverFg};
+	const char* samplers[] = {"noise", "fence", "coverBg", "coverFg"};
+	const char* sizes[] = {"noiseSize", "fenceSize", "coverBgSize", "coverFgSize"};
+
+	painter->beginNativePainting();
+
+	_program->bind();
+
+	for (int i = 0; i < 4; ++i)
+	{
+		activeTexture(GL_TEXTURE0 + i);
+		const_cast<QGLContext*>(context)->bindTexture(*textures[i], GL_TEXTURE_2D, GL_RGBA, options);
+		_program->setUniformValue(samplers[i], i);
+		_program->setUniformValue(sizes[i], QSizeF(textures[i]->size()));
+	}
+	activeTexture(GL_TEXTURE0);
+
+	_program->setUniformValue("matrix", matrix);
+	_program->setUniformValue("noiseOrigin0", _noiseOrigin[0]);
+	_program->setUniformValue("noiseOrigin1", _noiseOrigin[1]);
+	_program->setUniformValue("fenceOrigin", _fenceOrigin);
+	_program->setUniformValue("color", _color);
+	_program->setUniformValue("fade", static_cast<GLfloat>(_fade));
+	_program->setUniformValue("opacity", static_cast<GLfloat>(painter->opacity()));
+
+	_program->enableAttributeArray("vertex");
+	_program->setAttributeArray("vertex", vertices);
+
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+
+	_program->disableAttributeArray("vertex");
+	_program->release();
+
+	painter->endNativePainting();
+
+	return true;
+}
+
+void BackgroundItem::paintLayers(QPainter* painter, const QRectF& exposed)
+{
+	// Same stack without shaders, still one item so the scene only tracks a single repaint
+	qreal opacity = painter->opacity();
+
+	painter->fillRect(exposed, _color);
+	painter->drawTiledPixmap(exposed, _noise, getTileOffset(_noiseOrigin[0] - exposed.topLeft(), _noise.size()));
+
+	painter->setOpacity(opacity * _fade);
+	painter->fillRect(exposed, _color);
+	painter->drawTiledPixmap(exposed, _noise, getTileOffset(_noiseOrigin[1] - exposed.topLeft(), _noise.size()));
+	painter->setOpacity(opacity);
+
+	painter->drawTiledPixmap(exposed, _fence, getTileOffset(_fenceOrigin - exposed.topLeft(), _fence.size()));
+	painter->drawTiledPixmap(exposed, _coverBg, getTileOffset(-exposed.topLeft(), _coverBg.size()));
+	painter->drawTiledPixmap(exposed, _coverFg, getTileOffset(-exposed.topLeft(), _coverFg.size()));
+}
+
+QPointF BackgroundItem::getTileOffset(const QPointF& origin, const QSize& size)
+{
+	if (size.isEmpty())
+		return QPointF();
+
+	// Point of the pixmap that lands on the rect's corner, for a tiling anchored at origin
+	qreal x = fmod(-origin.x(), size.width());
+	qreal y = fmod(-origin.y(), size.height());
+
+	return QPointF((x < 0.0f) ? (x + size.width()) : x, (y < 0.0f) ? (y + size.height()) : y);
+}
@@ -0,0 +1,73 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KINETRIS_BACKGROUNDITEM_H
+#define KINETRIS_BACKGROUNDITEM_H
+
+#include <QtGui/QtGui>
+#include <QtOpenGL/QtOpenGL>
+
+class BackgroundItem : public QGraphicsItem
+{
+public:
+
+	BackgroundItem(const QSizeF& size, QGraphicsItem* parent = NULL);
+	virtual ~BackgroundItem();
+
+	void setColor(const QColor& color);
+	void setNoise(const QPixmap& pixmap);
+	void setFence(const QPixmap& pixmap, const QPointF& origin);
+	void setCover(const QPixmap& bg, const QPixmap& fg);
+
+	// Tile origins of the two noise layers, and how much of the second shows over the first
+	void setScroll(const QPointF& origin0, const QPointF& origin1, qreal fade);
+
+	virtual QRectF boundingRect() const;
+	virtual void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = NULL);
+
+protected:
+
+	static const char* VERTEX_SHADER;
+	static const char* FRAGMENT_SHADER;
+
+	QSizeF _size; // px
+
+	QColor _color;
+	QPixmap _noise;
+	QPixmap _fence;
+	QPixmap _coverBg;
+	QPixmap _coverFg;
+
+	QPointF _fenceOrigin; // px
+	QPointF _noiseOrigin[2]; // px
+	qreal _fade;
+
+	QGLShaderProgram* _program;
+	bool _shaded; // cleared once the shader path fails, so it is not retried every frame
+
+	bool initProgram();
+
+	bool paintShaded(QPainter* painter, const QRectF& exposed);
+	void paintLayers(QPainter* painter, const QRectF& exposed);
+
+	static QPointF getTileOffset(const QPointF& origin, const QSize& size);
+};
+
+#endif // KINETRIS_BACKGROUNDITEM_H
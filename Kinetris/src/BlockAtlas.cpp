@@ -0,0 +1,164 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BlockAtlas.h"
+
+#include "LoaderThread.h"
+
+BlockAtlas* BlockAtlas::_instance = NULL;
+
+const char* BlockAtlas::IMAGE_BLOCK[] = {
+	":/res/block-i.png",
+	":/res/block-o.png",
+	":/res/block-t.png",
+	":/res/block-s.png",
+	":/res/block-z.png",
+	":/res/block-j.png",
+	":/res/block-l.png"
+};
+const char* BlockAtlas::IMAGE_BLOCK_OTHER = ":/res/block-other.png";
+const char* BlockAtlas::IMAGE_BLOCK_GHOST = ":/res/block-ghost.png";
+
+int BlockAtlas::_image_frame[FRAME_TOTAL];
+
+BlockAtlas::BlockAtlas(QObject* parent)
+	: QObject(parent)
+{
+	init();
+}
+
+BlockAtlas::~BlockAtlas()
+{
+	_instance = NULL;
+}
+
+BlockAtlas* BlockAtlas::instance(QObject* parent)
+{
+	if (!_instance)
+		_instance = new BlockAtlas(parent);
+
+	return _instance;
+}
+
+BlockAtlas* BlockAtlas::instance()
+{
+	Q_ASSERT(_instance);
+
+	return _instance;
+}
+
+void BlockAtlas::initImages()
+{
+	LoaderThread* loader = LoaderThread::instance();
+
+	for (int i = 0; i < 7; ++i)
+	{
+		_image_frame[Ruleset::PIECE_I + i] = loader->getHandle(IMAGE_BLOCK[i]);
+	}
+	_image_frame[FRAME_OTHER] = loader->getHandle(IMAGE_BLOCK_OTHER);
+	_image_frame[FRAME_GHOST] = loader->getHandle(IMAGE_BLOCK_GHOST);
+}
+
+void BlockAtlas::init()
+{
+	// One row of frames, each with a transparent border so filtering never picks up a neighbour
+	_pixmap = QPixmap((BLOCK + (PADDING * 2)) * FRAME_TOTAL, BLOCK + (PADDING * 2));
+	_pixmap.fill(Qt::transparent);
+
+	for (int i = 0; i < FRAME_FLASH; ++i)
+	{
+		setFrame(i, LoaderThread::instance()->getPixmap(_image_frame[i]));
+	}
+
+	// Same coverage as a piece block, filled white, for tinting without an offscreen effect
+	QPixmap flash = LoaderThread::instance()->getPixmap(_image_frame[Ruleset::PIECE_I]);
+	{
+		QPainter painter(&flash);
+		painter.setCompositionMode(QPainter::CompositionMode_SourceIn);
+		painter.fillRect(flash.rect(), QColor::fromRgb(0xFF, 0xFF, 0xFF));
+	}
+	setFrame(FRAME_FLASH, flash);
+}
+
+qreal BlockAtlas::getBlockSize() const
+{
+	return BLOCK;
+}
+
+QPixmap BlockAtlas::getPixmap() const
+{
+	return _pixmap;
+}
+
+QPainter::PixmapFragment BlockAtlas::getFragment(int frame, const QPointF& center, qreal scale, qreal opacity) const
+{
+	return QPainter::PixmapFragment::create(center, getFrameRect(frame), scale, scale, 0.0f, opacity);
+}
+
+void BlockAtlas::draw(QPainter* painter, const QPainter::PixmapFragment* fragments, int count) const
+{
+	if (!count)
+		return;
+
+	painter->drawPixmapFragments(fragments, count, _pixmap);
+}
+
+QPixmap BlockAtlas::getShapePixmap(int frame, const QVector<Pair>& shape, qreal block)
+{
+	// Cells of the 4x4 box as a 16-bit mask, under the frame and size
+	quint32 key = 0;
+	foreach (const Pair& p, shape)
+	{
+		key |= 1 << ((p.row * 4) + p.col);
+	}
+	key |= (frame << 16) | (qRound(block) << 20);
+
+	QHash<quint32, QPixmap>::const_iterator i = _shapes.constFind(key);
+	if (i != _shapes.constEnd())
+		return i.value();
+
+	QPixmap pixmap(qCeil(block * 4), qCeil(block * 4));
+	pixmap.fill(Qt::transparent);
+
+	QPainter painter(&pixmap);
+	painter.setRenderHint(QPainter::SmoothPixmapTransform);
+	foreach (const Pair& p, shape)
+	{
+		// Row 0 is the bottom of the box
+		painter.drawPixmap(QRectF(p.col * block, (4 - p.row - 1) * block, block, block), _pixmap, getFrameRect(frame));
+	}
+	painter.end();
+
+	_shapes.insert(key, pixmap);
+
+	return pixmap;
+}
+
+void BlockAtlas::setFrame(int frame, const QPixmap& pixmap)
+{
+	QPainter painter(&_pixmap);
+	painter.setCompositionMode(QPainter::CompositionMode_Source);
+	painter.drawPixmap(getFrameRect(frame), pixmap, pixmap.rect());
+}
+
+QRectF BlockAtlas::getFrameRect(int frame) const
+{
+	return QRectF(((BLOCK + (PADDING * 2)) * frame) + PADDING, PADDING, BLOCK, BLOCK);
+}
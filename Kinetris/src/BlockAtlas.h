@@ -0,0 +1,87 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KINETRIS_BLOCKATLAS_H
+#define KINETRIS_BLOCKATLAS_H
+
+#include <QtGui/QtGui>
+
+#include "Pair.h"
+#include "Ruleset.h"
+
+class BlockAtlas : public QObject
+{
+public:
+
+	enum Frame
+	{
+		FRAME_GHOST = 0, // pieces use their Ruleset::Piece value
+		FRAME_OTHER = Ruleset::PIECE_L + 1,
+		FRAME_FLASH, // white silhouette, baked from the piece frames
+		FRAME_TOTAL
+	};
+
+	static const int BLOCK = 24; // px, the field's block size, which the block images are made at
+
+	virtual ~BlockAtlas();
+
+	static BlockAtlas* instance(QObject* parent);
+	static BlockAtlas* instance();
+
+	static void initImages();
+
+	qreal getBlockSize() const; // px
+	QPixmap getPixmap() const;
+
+	QPainter::PixmapFragment getFragment(int frame, const QPointF& center, qreal scale = 1.0f, qreal opacity = 1.0f) const;
+
+	void draw(QPainter* painter, const QPainter::PixmapFragment* fragments, int count) const;
+
+	// A whole piece in a 4x4 box, rendered once per frame, shape and size
+	QPixmap getShapePixmap(int frame, const QVector<Pair>& shape, qreal block);
+
+protected:
+
+	static const char* IMAGE_BLOCK[];
+	static const char* IMAGE_BLOCK_OTHER;
+	static const char* IMAGE_BLOCK_GHOST;
+
+	static int _image_frame[FRAME_TOTAL];
+
+	static const int PADDING = 1; // px
+
+	QPixmap _pixmap;
+
+	QHash<quint32, QPixmap> _shapes;
+
+	BlockAtlas(QObject* parent);
+
+	void init();
+
+	void setFrame(int frame, const QPixmap& pixmap);
+
+	QRectF getFrameRect(int frame) const;
+
+private:
+
+	static BlockAtlas* _instance;
+};
+
+#endif // KINETRIS_BLOCKATLAS_H
@@ -0,0 +1,244 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FieldItem.h"
+
+#include "BlockAtlas.h"
+
+FieldItem::FieldItem(const BlockAtlas* atlas, int rows, int cols, int attic, QGraphicsItem* parent)
+	: QGraphicsItem(parent)
+	, _atlas(atlas)
+	, _rows(rows)
+	, _cols(cols)
+	, _attic(attic)
+	, _block(atlas->getBlockSize())
+{
+	_clip = QRectF(0.0f, 0.0f, _cols * _block, _attic * _block);
+
+	// Leave room for rows that scale up to twice their size
+	_bounds = QRectF(0.0f, (_attic - _rows) * _block, _cols * _block, _rows * _block);
+	_bounds.adjust(_bounds.width() * -0.5f, -_block, _bounds.width() * 0.5f, _block);
+
+	_cells.fill(Ruleset::PIECE_NONE, _rows * _cols);
+	_counts.fill(0, _rows);
+
+	RowStyle style = {0.0f, 1.0f, 1.0f, false};
+	_styles.fill(style, _rows);
+
+	setFlags(QGraphicsItem::ItemUsesExtendedStyleOption);
+}
+
+FieldItem::~FieldItem()
+{
+}
+
+Ruleset::Piece FieldItem::getCell(int row, int col) const
+{
+	return _cells[(row * _cols) + col];
+}
+
+void FieldItem::setCell(int row, int col, Ruleset::Piece piece)
+{
+	Ruleset::Piece& cell = _cells[(row * _cols) + col];
+	if (cell == piece)
+		return;
+
+	if (!cell)
+	{
+		++_counts[row];
+	}
+	else if (!piece)
+	{
+		--_counts[row];
+	}
+	cell = piece;
+
+	updateRow(row);
+}
+
+bool FieldItem::isEmpty(int row) const
+{
+	return !_counts[row];
+}
+
+void FieldItem::clear(int row)
+{
+	if (!_counts[row])
+		return;
+
+	for (int col = 0; col < _cols; ++col)
+	{
+		_cells[(row * _cols) + col] = Ruleset::PIECE_NONE;
+	}
+	_counts[row] = 0;
+
+	updateRow(row);
+}
+
+void FieldItem::clear()
+{
+	_cells.fill(Ruleset::PIECE_NONE);
+	_counts.fill(0);
+
+	update();
+}
+
+void FieldItem::collapse(int start)
+{
+	if (start < _rows - 1)
+	{
+		memmove(&_cells[start * _cols], &_cells[(start + 1) * _cols],
+			sizeof(Ruleset::Piece) * (_rows - (start + 1)) * _cols);
+
+		memmove(&_counts[start], &_counts[start + 1],
+			sizeof(int) * (_rows - (start + 1)));
+	}
+
+	for (int col = 0; col < _cols; ++col)
+	{
+		_cells[((_rows - 1) * _cols) + col] = Ruleset::PIECE_NONE;
+	}
+	_counts[_rows - 1] = 0;
+
+	for (int row = start; row < _rows; ++row)
+	{
+		updateRow(row);
+	}
+}
+
+void FieldItem::setRowStyle(int row, qreal offset, qreal scale, qreal opacity, bool raised)
+{
+	RowStyle& style = _styles[row];
+	if ((style.offset == offset)
+		&& (style.scale == scale)
+		&& (style.opacity == opacity)
+		&& (style.raised == raised))
+		return;
+
+	// Empty rows have nothing to repaint
+	bool dirty = (_counts[row] != 0);
+	if (dirty)
+	{
+		updateRow(row);
+	}
+
+	style.offset = offset;
+	style.scale = scale;
+	style.opacity = opacity;
+	style.raised = raised;
+
+	if (dirty)
+	{
+		updateRow(row);
+	}
+}
+
+void FieldItem::resetRowStyles()
+{
+	for (int row = 0; row < _rows; ++row)
+	{
+		setRowStyle(row, 0.0f, 1.0f, 1.0f, false);
+	}
+}
+
+QRectF FieldItem::boundingRect() const
+{
+	return _bounds;
+}
+
+void FieldItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+	// Prevent "unreferenced formal parameter" warning
+	widget;
+
+	const QRectF& exposed = option->exposedRect;
+
+	// One batch for the rows inside the field, one for raised rows
+	QVarLengthArray<QPainter::PixmapFragment, FRAGMENTS> fragments;
+
+	for (int row = 0; row < _rows; ++row)
+	{
+		if (_styles[row].raised)
+			continue;
+
+		appendRow(fragments, row, exposed);
+	}
+
+	painter->save();
+	painter->setClipRect(_clip, Qt::IntersectClip);
+	_atlas->draw(painter, fragments.constData(), fragments.count());
+	painter->restore();
+
+	fragments.clear();
+
+	for (int row = 0; row < _rows; ++row)
+	{
+		if (!_styles[row].raised)
+			continue;
+
+		appendRow(fragments, row, exposed);
+	}
+
+	_atlas->draw(painter, fragments.constData(), fragments.count());
+}
+
+QRectF FieldItem::getRowRect(int row) const
+{
+	const RowStyle& style = _styles[row];
+
+	QRectF rect(0.0f, (_attic - row - 1) * _block, _cols * _block, _block);
+	QPointF center = rect.center();
+	rect.setSize(rect.size() * style.scale);
+	rect.moveCenter(center + QPointF(0.0f, style.offset));
+	return rect;
+}
+
+void FieldItem::updateRow(int row)
+{
+	update(getRowRect(row));
+}
+
+void FieldItem::appendRow(QVarLengthArray<QPainter::PixmapFragment, FRAGMENTS>& fragments, int row, const QRectF& exposed) const
+{
+	if (!_counts[row])
+		return;
+
+	const RowStyle& style = _styles[row];
+	if (style.opacity <= 0.0f)
+		return;
+
+	QRectF rect = getRowRect(row);
+	if (!rect.intersects(exposed))
+		return;
+
+	// Cells scale about the row center
+	const qreal block = _block * style.scale;
+	const QPointF origin = rect.topLeft() + QPointF(block * 0.5f, block * 0.5f);
+
+	const Ruleset::Piece* cell = &_cells[row * _cols];
+	for (int col = 0; col < _cols; ++col)
+	{
+		if (!cell[col])
+			continue;
+
+		fragments.append(_atlas->getFragment(cell[col],
+			origin + QPointF(col * block, 0.0f), style.scale, style.opacity));
+	}
+}
@@ -0,0 +1,84 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KINETRIS_FIELDITEM_H
+#define KINETRIS_FIELDITEM_H
+
+#include <QtGui/QtGui>
+
+#include "Ruleset.h"
+
+class BlockAtlas;
+
+class FieldItem : public QGraphicsItem
+{
+public:
+
+	FieldItem(const BlockAtlas* atlas, int rows, int cols, int attic, QGraphicsItem* parent = NULL);
+	virtual ~FieldItem();
+
+	Ruleset::Piece getCell(int row, int col) const;
+	void setCell(int row, int col, Ruleset::Piece piece);
+
+	bool isEmpty(int row) const;
+	void clear(int row);
+	void clear();
+	void collapse(int start);
+
+	void setRowStyle(int row, qreal offset, qreal scale, qreal opacity, bool raised);
+	void resetRowStyles();
+
+	virtual QRectF boundingRect() const;
+	virtual void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = NULL);
+
+protected:
+
+	struct RowStyle
+	{
+		qreal offset; // px
+		qreal scale;
+		qreal opacity;
+		bool raised; // drawn outside the field clip
+	};
+
+	static const int FRAGMENTS = 256;
+
+	const BlockAtlas* _atlas;
+
+	int _rows;
+	int _cols;
+	int _attic;
+	qreal _block; // px
+
+	QRectF _clip;
+	QRectF _bounds;
+
+	QVector<Ruleset::Piece> _cells;
+	QVector<int> _counts;
+	QVector<RowStyle> _styles;
+
+	QRectF getRowRect(int row) const;
+
+	void updateRow(int row);
+
+	void appendRow(QVarLengthArray<QPainter::PixmapFragment, FRAGMENTS>& fragments, int row, const QRectF& exposed) const;
+};
+
+#endif // KINETRIS_FIELDITEM_H
@@ -1,815 +1,1179 @@
-/**
- * This file is part of Kinetris.
- * 
- * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
- * Contact: Conan Chen <http://conanchen.com/>
- * 
- * This program is free software: you can redistribute it and/or modify
- * it under the terms of the GNU General Public License as published by
- * the Free Software Foundation, either version 3 of the License, or
- * (at your option) any later version.
- * 
- * This program is distributed in the hope that it will be useful,
- * but WITHOUT ANY WARRANTY; without even the implied warranty of
- * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- * GNU General Public License for more details.
- * 
- * You should have received a copy of the GNU General Public License
- * along with this program.  If not, see <http://www.gnu.org/licenses/>.
- */
-
-#include "Game.h"
-
-#include "Kinetris.h"
-#include "SensorThread.h"
-#include "LoaderThread.h"
-#include "Background.h"
-#include "HomeScreen.h"
-#include "PlayScreen.h"
-#include "MenuScreen.h"
-#include "QuitScreen.h"
-#include "Player.h"
-#include "InputManager.h"
-#include "VisualMatrix.h"
-#include "Tetromino.h"
-#include "Pair.h"
-
-const qreal Game::UPDATE_INTERVAL = 1000.0f / 30.0f; // ms
-
-Game::Game(Kinetris* parent)
-	: QGraphicsScene(parent)
-{
-	init();
-}
-
-Game::~Game()
-{
-}
-
-void Game::init()
-{
-	_player = NULL;
-	_inputManager = NULL;
-	_matrix = NULL;
-
-	initSensor();
-	initLoader();
-	initStyle();
-	initState();
-	initTimer();
-}
-
-void Game::initSensor()
-{
-	_sensorThread = new SensorThread(this);
-	
-	QObject::connect(_sensorThread, SIGNAL(evConnectBegin()), this, SLOT(onConnectBegin()));
-	QObject::connect(_sensorThread, SIGNAL(evConnectError()), this, SLOT(onConnectError()));
-	QObject::connect(_sensorThread, SIGNAL(evConnect()), this, SLOT(onConnect()));
-	QObject::connect(_sensorThread, SIGNAL(evDisconnect()), this, SLOT(onDisconnect()));
-	QObject::connect(_sensorThread, SIGNAL(finished()), _sensorThread, SLOT(start()));
-
-	QObject::connect(_sensorThread, SIGNAL(evUserEnter()), this, SLOT(onUserEnter()));
-	QObject::connect(_sensorThread, SIGNAL(evUserLeave()), this, SLOT(onUserLeave()));
-
-	QObject::connect(_sensorThread, SIGNAL(evSessionBegin()), this, SLOT(onSessionBegin()));
-	QObject::connect(_sensorThread, SIGNAL(evSessionEnd()), this, SLOT(onSessionEnd()));
-
-	QObject::connect(_sensorThread, SIGNAL(evFocusGain()), this, SLOT(onFocusGain()));
-	QObject::connect(_sensorThread, SIGNAL(evFocusLose()), this, SLOT(onFocusLose()));
-	QObject::connect(_sensorThread, SIGNAL(evFocusSwap()), this, SLOT(onFocusSwap()));
-
-	QObject::connect(_sensorThread, SIGNAL(evSteadyBegin()), this, SLOT(onSteadyBegin()));
-	QObject::connect(_sensorThread, SIGNAL(evSteadyEnd()), this, SLOT(onSteadyEnd()));
-	QObject::connect(_sensorThread, SIGNAL(evCircle(int)), this, SLOT(onCircle(int)));
-	QObject::connect(_sensorThread, SIGNAL(evSlideX(qreal)), this, SLOT(onSlideX(qreal)));
-	QObject::connect(_sensorThread, SIGNAL(evSlideY(qreal)), this, SLOT(onSlideY(qreal)));
-	QObject::connect(_sensorThread, SIGNAL(evSlideZ(qreal)), this, SLOT(onSlideZ(qreal)));
-	QObject::connect(_sensorThread, SIGNAL(evSwipeX(int, qreal, qreal)), this, SLOT(onSwipeX(int, qreal, qreal)));
-	QObject::connect(_sensorThread, SIGNAL(evSwipeY(int, qreal, qreal)), this, SLOT(onSwipeY(int, qreal, qreal)));
-	QObject::connect(_sensorThread, SIGNAL(evPush(qreal, qreal)), this, SLOT(onPush(qreal, qreal)));
-	QObject::connect(_sensorThread, SIGNAL(evWave()), this, SLOT(onWave()));
-
-	qRegisterMetaType<QImage>("QImage");
-	QObject::connect(_sensorThread, SIGNAL(evUsersMap(QImage)), this, SLOT(onUsersMap(QImage)));
-}
-
-void Game::initLoader()
-{
-	_loaderThread = LoaderThread::instance(this);
-}
-
-void Game::initStyle()
-{
-	QFont::insertSubstitution("Arial Black", "Arial");
-
-	QFont font("Arial Black");
-	font.setPixelSize(16);
-	font.setWeight(QFont::Black);
-	font.setStretch(80);
-
-	QApplication::setFont(font);
-}
-
-void Game::initState()
-{
-	_state = STATE_NONE;
-	_s1 = STATE_NONE;
-}
-
-void Game::initTimer()
-{
-	_t0 = QDateTime::currentMSecsSinceEpoch();
-	_timer = startTimer(UPDATE_INTERVAL);
-
-	qsrand(_t0);
-}
-
-void Game::initSprite()
-{
-	_background = new Background(this);
-	addItem(_background->getSprite());
-
-	_homeScreen = new HomeScreen(this);
-	addItem(_homeScreen->getSprite());
-	_homeScreen->hide();
-
-	_playScreen = new PlayScreen(this);
-	addItem(_playScreen->getSprite());
-	_playScreen->hide();
-
-	_menuScreen = new MenuScreen(this);
-	addItem(_menuScreen->getSprite());
-	_menuScreen->getSprite()->setZValue(8.0f);
-	_menuScreen->hide();
-
-	_quitScreen = new QuitScreen(this);
-	addItem(_quitScreen->getSprite());
-	_quitScreen->getSprite()->setZValue(8.0f);
-	_quitScreen->hide();
-}
-
-void Game::initEffect()
-{
-}
-
-void Game::initPlayer()
-{
-	_player = new Player(this);
-
-	_inputManager = new InputManager(this);
-	_player->setInputManager(_inputManager);
-
-	QObject::connect(_player, SIGNAL(evPlay()), this, SLOT(onPlay()));
-	QObject::connect(_player, SIGNAL(evQuit(bool)), this, SLOT(onQuit(bool)));
-}
-
-void Game::initMatrix()
-{
-	if (_matrix)
-		_matrix->deleteLater();
-
-	_matrix = new VisualMatrix(this);
-	_player->setMatrix(_matrix);
-	_playScreen->setMatrix(_matrix);
-
-	QObject::connect(_matrix, SIGNAL(evLevel(int)), this, SLOT(onLevel(int)));
-}
-
-Game::State Game::getState() const
-{
-	return _state;
-}
-
-void Game::setState(State state)
-{
-	_s1 = state;
-}
-
-void Game::update(qreal dt)
-{
-	if (_state != _s1)
-	{
-		onStateLeave(_state);
-		_state = _s1;
-		onStateEnter(_state);
-	}
-
-	if (!_state)
-	{
-		setState(STATE_INIT);
-	}
-	else if (_state == STATE_INIT)
-	{
-	}
-	else if (_state == STATE_HOME)
-	{
-		_background->update(dt);
-		_homeScreen->update(dt);
-
-		_inputManager->update(dt);
-
-		_player->update(dt);
-	}
-	else if (_state == STATE_PLAY)
-	{
-		_background->update(dt);
-		_playScreen->update(dt);
-
-		// 1. Game state is created/updated
-		// 2. Visual is updated
-		// 3. In-between frames
-		// 4. Player reacts to visual
-
-		// Freeze input reacting to previous frame
-		_inputManager->update(dt);
-
-		// Player processing
-		// Apply input or AI
-		_player->update(dt);
-
-		// Update game state
-		_matrix->update(dt);
-	}
-	else if (_state == STATE_MENU)
-	{
-		_menuScreen->update(dt);
-
-		_inputManager->update(dt);
-
-		_player->update(dt);
-	}
-	else if (_state == STATE_QUIT)
-	{
-		_quitScreen->update(dt);
-
-		_inputManager->update(dt);
-
-		_player->update(dt);
-	}
-}
-
-void Game::onStateEnter(State state)
-{
-	if (!state)
-	{
-	}
-	else if (state == STATE_INIT)
-	{
-		initSprite();
-		initEffect();
-
-		initPlayer();
-
-		_sensorThread->start();
-
-		setState(STATE_HOME);
-	}
-	else if (state == STATE_HOME)
-	{
-		_quitScreen->hide();
-		_menuScreen->hide();
-		_playScreen->hide();
-		_homeScreen->show();
-
-		initMatrix();
-
-		_player->setState(Player::STATE_HOME);
-
-		_background->setSpeed(_matrix->getLevel());
-	}
-	else if (state == STATE_PLAY)
-	{
-		_quitScreen->hide();
-		_menuScreen->hide();
-		_homeScreen->hide();
-		_playScreen->show();
-
-		_player->setState(Player::STATE_PLAY);
-	}
-	else if (state == STATE_MENU)
-	{
-		_quitScreen->hide();
-		_menuScreen->show();
-
-		_player->setState(Player::STATE_MENU);
-	}
-	else if (state == STATE_QUIT)
-	{
-		_quitScreen->show();
-
-		_player->setState(Player::STATE_QUIT);
-	}
-}
-
-void Game::onStateLeave(State state)
-{
-	if (!state)
-	{
-	}
-	else if (state == STATE_INIT)
-	{
-	}
-	else if (state == STATE_HOME)
-	{
-	}
-	else if (state == STATE_PLAY)
-	{
-	}
-	else if (state == STATE_MENU)
-	{
-	}
-	else if (state == STATE_QUIT)
-	{
-	}
-}
-
-void Game::timerEvent(QTimerEvent* event)
-{
-	if (event->timerId() == _timer)
-	{
-		qint64 t = QDateTime::currentMSecsSinceEpoch();
-		int dt = qMin<qreal>(UPDATE_INTERVAL, t - _t0);
-		update(dt);
-		_t0 = t;
-	}
-	else
-	{
-		QGraphicsScene::timerEvent(event);
-	}
-}
-
-void Game::keyPressEvent(QKeyEvent* event)
-{
-	if (!_state)
-	{
-	}
-	else if (_state == STATE_INIT)
-	{
-	}
-	else if (_state == STATE_HOME)
-	{
-		if (event->key() == Qt::Key_Escape)
-		{
-			_inputManager->setState(InputManager::INPUT_PLAY, 1.0f, true);
-
-			setState(Game::STATE_PLAY);
-		}
-	}
-	else if (_state == STATE_PLAY)
-	{
-		if (event->key() == Qt::Key_Escape)
-		{
-			_inputManager->setState(InputManager::INPUT_PLAY, 1.0f, true);
-
-			if (static_cast<Matrix*>(_matrix)->getState() == Matrix::STATE_OVER)
-				setState(STATE_HOME);
-			else
-				setState(STATE_MENU);
-		}
-	}
-	else if (_state == STATE_MENU)
-	{
-		if (event->key() == Qt::Key_Escape)
-		{
-			_inputManager->setState(InputManager::INPUT_PLAY, 1.0f, true);
-
-			setState(Game::STATE_PLAY);
-		}
-	}
-	else if (_state == STATE_QUIT)
-	{
-		if (event->key() == Qt::Key_Escape)
-		{
-			_inputManager->setState(InputManager::INPUT_PLAY, 1.0f, true);
-
-			setState(Game::STATE_PLAY);
-		}
-	}
-
-	QGraphicsScene::keyPressEvent(event);
-}
-
-void Game::keyReleaseEvent(QKeyEvent* event)
-{
-	if (!_state)
-	{
-	}
-	else if (_state == STATE_INIT)
-	{
-	}
-	else if (_state == STATE_HOME)
-	{
-		//
-	}
-	else if (_state == STATE_PLAY)
-	{
-		//
-	}
-	else if (_state == STATE_MENU)
-	{
-		//
-	}
-	else if (_state == STATE_QUIT)
-	{
-		//
-	}
-
-	QGraphicsScene::keyReleaseEvent(event);
-}
-
-void Game::onConnectBegin()
-{
-	if (!_state)
-	{
-	}
-	else if (_state == STATE_INIT)
-	{
-	}
-	else if (_state == STATE_HOME)
-	{
-		_homeScreen->setStatus(tr("Connecting to sensor..."));
-	}
-	else if (_state == STATE_PLAY)
-	{
-	}
-	else if (_state == STATE_MENU)
-	{
-	}
-	else if (_state == STATE_QUIT)
-	{
-	}
-}
-
-void Game::onConnectError()
-{
-	if (!_state)
-	{
-	}
-	else if (_state == STATE_INIT)
-	{
-	}
-	else if (_state == STATE_HOME)
-	{
-		_homeScreen->setStatus(tr("Unable to connect to sensor."));
-	}
-	else if (_state == STATE_PLAY)
-	{
-	}
-	else if (_state == STATE_MENU)
-	{
-	}
-	else if (_state == STATE_QUIT)
-	{
-	}
-}
-
-void Game::onConnect()
-{
-	if (!_state)
-	{
-	}
-	else if (_state == STATE_INIT)
-	{
-	}
-	else if (_state == STATE_HOME)
-	{
-		_homeScreen->setStatus(tr("Detecting player... (Please step back from the sensor.)"));
-	}
-	else if (_state == STATE_PLAY)
-	{
-	}
-	else if (_state == STATE_MENU)
-	{
-		_menuScreen->setStatus(tr("Wave to continue."));
-	}
-	else if (_state == STATE_QUIT)
-	{
-	}
-}
-
-void Game::onDisconnect()
-{
-	if (!_state)
-	{
-	}
-	else if (_state == STATE_INIT)
-	{
-	}
-	else if (_state == STATE_HOME)
-	{
-		_homeScreen->setStatus(tr("Lost connection to sensor."));
-	}
-	else if (_state == STATE_PLAY)
-	{
-		_menuScreen->setStatus(tr("Lost connection to sensor. Reconnecting..."));
-		setState(STATE_MENU);
-	}
-	else if (_state == STATE_MENU)
-	{
-		_menuScreen->setStatus(tr("Lost connection to sensor. Reconnecting..."));
-	}
-	else if (_state == STATE_QUIT)
-	{
-		_menuScreen->setStatus(tr("Lost connection to sensor. Reconnecting..."));
-		setState(STATE_MENU);
-	}
-}
-
-void Game::onUserEnter()
-{
-	if (!_state)
-	{
-	}
-	else if (_state == STATE_INIT)
-	{
-	}
-	else if (_state == STATE_HOME)
-	{
-		_homeScreen->setStatus(tr("Wave to start."));
-	}
-	else if (_state == STATE_PLAY)
-	{
-	}
-	else if (_state == STATE_MENU)
-	{
-	}
-	else if (_state == STATE_QUIT)
-	{
-	}
-}
-
-void Game::onUserLeave()
-{
-	if (!_state)
-	{
-	}
-	else if (_state == STATE_INIT)
-	{
-	}
-	else if (_state == STATE_HOME)
-	{
-	}
-	else if (_state == STATE_PLAY)
-	{
-	}
-	else if (_state == STATE_MENU)
-	{
-	}
-	else if (_state == STATE_QUIT)
-	{
-	}
-}
-
-void Game::onSessionBegin()
-{
-	if (!_state)
-	{
-	}
-	else if (_state == STATE_INIT)
-	{
-	}
-	else if (_state == STATE_HOME)
-	{
-		setState(Game::STATE_PLAY);
-	}
-	else if (_state == STATE_PLAY)
-	{
-	}
-	else if (_state == STATE_MENU)
-	{
-		setState(Game::STATE_PLAY);
-	}
-	else if (_state == STATE_QUIT)
-	{
-	}
-}
-
-void Game::onSessionEnd()
-{
-	if (!_state)
-	{
-	}
-	else if (_state == STATE_INIT)
-	{
-	}
-	else if (_state == STATE_HOME)
-	{
-		_homeScreen->setStatus(tr("Wave to start."));
-	}
-	else if (_state == STATE_PLAY)
-	{
-		_menuScreen->setStatus(tr("Wave to continue."));
-		setState(STATE_MENU);
-	}
-	else if (_state == STATE_MENU)
-	{
-	}
-	else if (_state == STATE_QUIT)
-	{
-		_menuScreen->setStatus(tr("Wave to continue."));
-		setState(STATE_MENU);
-	}
-}
-
-void Game::onFocusGain()
-{
-	qDebug() << "FocusGain";
-
-	if (!_state)
-	{
-	}
-	else if (_state == STATE_INIT)
-	{
-	}
-	else if (_state == STATE_HOME)
-	{
-	}
-	else if (_state == STATE_PLAY)
-	{
-		//
-	}
-	else if (_state == STATE_MENU)
-	{
-		//
-	}
-	else if (_state == STATE_QUIT)
-	{
-		//
-	}
-}
-
-void Game::onFocusLose()
-{
-	qDebug() << "FocusLose";
-
-	if (!_state)
-	{
-	}
-	else if (_state == STATE_INIT)
-	{
-	}
-	else if (_state == STATE_HOME)
-	{
-	}
-	else if (_state == STATE_PLAY)
-	{
-		//
-	}
-	else if (_state == STATE_MENU)
-	{
-		//
-	}
-	else if (_state == STATE_QUIT)
-	{
-		//
-	}
-}
-
-void Game::onFocusSwap()
-{
-}
-
-void Game::onSteadyBegin()
-{
-	_inputManager->setState(InputManager::INPUT_NONE, 1.0f);
-}
-
-void Game::onSteadyEnd()
-{
-	_inputManager->setState(InputManager::INPUT_NONE, 0.0f);
-}
-
-void Game::onCircle(int direction)
-{
-	if (!direction)
-	{
-		_inputManager->setState(InputManager::INPUT_L1, 0.0f, true);
-		_inputManager->setState(InputManager::INPUT_R1, 0.0f, true);
-	}
-	else if (direction < 0)
-	{
-		_inputManager->setState(InputManager::INPUT_L1, 1.0f, true);
-	}
-	else if (direction > 0)
-	{
-		_inputManager->setState(InputManager::INPUT_R1, 1.0f, true);
-	}
-}
-
-void Game::onSlideX(qreal direction)
-{
-	_inputManager->setState(InputManager::INPUT_X1, direction);
-}
-
-void Game::onSlideY(qreal direction)
-{
-	_inputManager->setState(InputManager::INPUT_Y1, direction);
-}
-
-void Game::onSlideZ(qreal direction)
-{
-	_inputManager->setState(InputManager::INPUT_Z1, -direction);
-}
-
-void Game::onSwipeX(int direction, qreal speed, qreal angle)
-{
-	// Prevent "unreferenced formal parameter" warning
-	speed;
-	angle;
-
-	_inputManager->setState(InputManager::INPUT_X2, direction, true);
-}
-
-void Game::onSwipeY(int direction, qreal speed, qreal angle)
-{
-	// Prevent "unreferenced formal parameter" warning
-	speed;
-	angle;
-
-	_inputManager->setState(InputManager::INPUT_Y2, direction, true);
-}
-
-void Game::onPush(qreal speed, qreal angle)
-{
-	// Prevent "unreferenced formal parameter" warning
-	speed;
-	angle;
-
-	_inputManager->setState(InputManager::INPUT_Z2, 1.0f, true);
-}
-
-void Game::onWave()
-{
-	_inputManager->setState(InputManager::INPUT_PLAY, 1.0f, true);
-
-	if (!_state)
-	{
-	}
-	else if (_state == STATE_INIT)
-	{
-	}
-	else if (_state == STATE_HOME)
-	{
-	}
-	else if (_state == STATE_PLAY)
-	{
-		if (static_cast<Matrix*>(_matrix)->getState() == Matrix::STATE_OVER)
-			setState(STATE_HOME);
-//		else
-//			setState(STATE_MENU);
-	}
-	else if (_state == STATE_MENU)
-	{
-		setState(STATE_PLAY);
-	}
-	else if (_state == STATE_QUIT)
-	{
-		setState(STATE_PLAY);
-	}
-}
-
-void Game::onUsersMap(QImage image)
-{
-	if (!_state)
-	{
-	}
-	else if (_state == STATE_INIT)
-	{
-	}
-	else if (_state == STATE_HOME)
-	{
-		_homeScreen->setAvatar(QPixmap::fromImage(image));
-	}
-	else if (_state == STATE_PLAY)
-	{
-		_matrix->setAvatar(QPixmap::fromImage(image));
-	}
-	else if (_state == STATE_MENU)
-	{
-	}
-	else if (_state == STATE_QUIT)
-	{
-	}
-}
-
-void Game::onLevel(int count)
-{
-	// Prevent "unreferenced formal parameter" warning
-	count;
-
-	_background->setSpeed(_matrix->getRules()->getSpeed(_matrix->getLevel()));
-}
-
-void Game::onPlay()
-{
-	setState(STATE_PLAY);
-}
-
-void Game::onQuit(bool force)
-{
-	if (force)
-		QApplication::closeAllWindows();
-	else
-		setState(STATE_QUIT);
-}
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Game.h"
+
+#include "Kinetris.h"
+#include "InputSource.h"
+#include "SensorThread.h"
+#include "KeyboardSource.h"
+#include "SyntheticSource.h"
+#include "LoaderThread.h"
+#include "BlockAtlas.h"
+#include "LatencyTracer.h"
+#include "Background.h"
+#include "HomeScreen.h"
+#include "PlayScreen.h"
+#include "MenuScreen.h"
+#include "QuitScreen.h"
+#include "Player.h"
+#include "InputManager.h"
+#include "VisualMatrix.h"
+#include "Tetromino.h"
+#include "Pair.h"
+
+const qreal Game::UPDATE_INTERVAL = 1000.0f / 30.0f; // ms
+
+const qreal Game::HAND_RANGE = 300.0f; // mm
+
+Game::Game(Kinetris* parent)
+	: QGraphicsScene(parent)
+{
+	init();
+}
+
+Game::~Game()
+{
+}
+
+void Game::init()
+{
+	_player = NULL;
+	_inputManager = NULL;
+	_matrix = NULL;
+
+	_handAnchored = false;
+	_handAnchor = 0.0f;
+
+	_rate = getRateOption("rate");
+
+	initTracer();
+	initInput();
+	initLoader();
+	initStyle();
+	initState();
+	initTimer();
+}
+
+void Game::initTracer()
+{
+	// Written on F12, and when the game quits
+	LatencyTracer::instance(this)->setPath(getOption("trace"));
+}
+
+void Game::initInput()
+{
+	// Hand gestures from the sensor (default), a recording of it, the keyboard, or a synthetic hand
+	QString input = getOption("input");
+
+	if (input == "keyboard")
+	{
+		_inputSource = new KeyboardSource(this);
+	}
+	else if (input == "synthetic")
+	{
+		SyntheticSource* syntheticSource = new SyntheticSource(this);
+		syntheticSource->setRate(_rate);
+
+		_inputSource = syntheticSource;
+	}
+	else
+	{
+		SensorThread* sensorThread = new SensorThread(this);
+		sensorThread->setRecordPath(getOption("record"));
+		sensorThread->setPlaybackPath(getOption("playback"), getRateOption("playback-rate"));
+		sensorThread->setNativeGestures(getOption("gestures") == "native");
+		sensorThread->setHandFiltered(getOption("filter") != "none");
+		sensorThread->setDepthOnly(getOption("avatar") == "depth");
+
+		// e.g. 320x240@60 to react sooner, or 640x480@30 for a sharper avatar
+		QRegExp mode("(\\d+)x(\\d+)@(\\d+)");
+		if (mode.exactMatch(getOption("mode")))
+		{
+			XnMapOutputMode captureMode;
+			captureMode.nXRes = mode.cap(1).toUInt();
+			captureMode.nYRes = mode.cap(2).toUInt();
+			captureMode.nFPS = mode.cap(3).toUInt();
+			sensorThread->setCaptureMode(captureMode);
+		}
+
+		_inputSource = sensorThread;
+	}
+	
+	QObject::connect(_inputSource, SIGNAL(evConnectBegin()), this, SLOT(onConnectBegin()));
+	QObject::connect(_inputSource, SIGNAL(evConnectError()), this, SLOT(onConnectError()));
+	QObject::connect(_inputSource, SIGNAL(evConnect()), this, SLOT(onConnect()));
+	QObject::connect(_inputSource, SIGNAL(evDisconnect()), this, SLOT(onDisconnect()));
+	QObject::connect(_inputSource, SIGNAL(finished()), _inputSource, SLOT(start()));
+
+	qRegisterMetaType<QImage>("QImage");
+	QObject::connect(_inputSource, SIGNAL(evUsersMap(QImage, QPoint, QSize)), this, SLOT(onUsersMap(QImage, QPoint, QSize)));
+}
+
+QString Game::getOption(const QString& name)
+{
+	// Options are given as "--name=value", or "--name" alone for "1"
+	QString prefix = QString("--%1").arg(name);
+
+	foreach (QString arg, QApplication::arguments())
+	{
+		if (arg == prefix)
+			return "1";
+
+		if (arg.startsWith(prefix + "="))
+			return arg.mid(prefix.length() + 1);
+	}
+
+	return QString();
+}
+
+qreal Game::getRateOption(const QString& name)
+{
+	QString value = getOption(name);
+	if (value.isEmpty())
+		return 1.0f;
+
+	// 0 is a valid rate, so a typo must not quietly parse as one
+	bool ok = false;
+	qreal rate = value.toDouble(&ok);
+	if ((!ok) || (rate < 0.0f))
+	{
+		qWarning("Invalid --%s=%s, using 1", qPrintable(name), qPrintable(value));
+		return 1.0f;
+	}
+
+	return rate;
+}
+
+void Game::initLoader()
+{
+	_loaderThread = LoaderThread::instance(this);
+
+	QString cache = getOption("cache");
+	if (!cache.isEmpty())
+	{
+		// A budget of 0 or less would evict every image as soon as it decodes
+		bool ok = false;
+		qint64 megabytes = cache.toLongLong(&ok);
+		if ((!ok) || (megabytes <= 0))
+		{
+			qWarning("Invalid --cache=%s, using the default", qPrintable(cache));
+		}
+		else
+		{
+			// Decoded images and pixmaps each get this much
+			qint64 budget = megabytes * 1024 * 1024;
+			_loaderThread->setImageBudget(budget);
+			_loaderThread->setPixmapBudget(budget);
+		}
+	}
+
+	_loaderThread->start();
+
+	// Resolve every image to a handle up front; they decode in the order the screens come up, while the sensor is still starting
+	BlockAtlas::initImages();
+	Background::initImages();
+	HomeScreen::initImages();
+	VisualMatrix::initImages();
+
+	// Every block sprite draws from the one atlas texture
+	BlockAtlas::instance(this);
+}
+
+void Game::initStyle()
+{
+	QFont::insertSubstitution("Arial Black", "Arial");
+
+	QFont font("Arial Black");
+	font.setPixelSize(16);
+	font.setWeight(QFont::Black);
+	font.setStretch(80);
+
+	QApplication::setFont(font);
+}
+
+void Game::initState()
+{
+	_state = STATE_NONE;
+	_s1 = STATE_NONE;
+}
+
+void Game::initTimer()
+{
+	_t0 = QDateTime::currentMSecsSinceEpoch();
+	_timer = startTimer((_rate > 0.0f) ? (UPDATE_INTERVAL / _rate) : 0);
+
+	qsrand(_t0);
+}
+
+void Game::initSprite()
+{
+	_background = new Background(this);
+	addItem(_background->getSprite());
+
+	_homeScreen = new HomeScreen(this);
+	addItem(_homeScreen->getSprite());
+	_homeScreen->hide();
+
+	_playScreen = new PlayScreen(this);
+	addItem(_playScreen->getSprite());
+	_playScreen->hide();
+
+	_menuScreen = new MenuScreen(this);
+	addItem(_menuScreen->getSprite());
+	_menuScreen->getSprite()->setZValue(8.0f);
+	_menuScreen->hide();
+
+	_quitScreen = new QuitScreen(this);
+	addItem(_quitScreen->getSprite());
+	_quitScreen->getSprite()->setZValue(8.0f);
+	_quitScreen->hide();
+}
+
+void Game::initEffect()
+{
+}
+
+void Game::initPlayer()
+{
+	_player = new Player(this);
+
+	_player->setControl((getOption("control") == "direct")
+		? Player::CONTROL_DIRECT
+		: Player::CONTROL_GESTURE);
+
+	_inputManager = new InputManager(this);
+	_player->setInputManager(_inputManager);
+
+	QObject::connect(_player, SIGNAL(evPlay()), this, SLOT(onPlay()));
+	QObject::connect(_player, SIGNAL(evQuit(bool)), this, SLOT(onQuit(bool)));
+}
+
+void Game::initMatrix()
+{
+	// Later games reuse the first one's sprite tree rather than rebuilding it
+	if (_matrix)
+	{
+		_matrix->reset();
+		return;
+	}
+
+	_matrix = new VisualMatrix(this);
+	_player->setMatrix(_matrix);
+	_playScreen->setMatrix(_matrix);
+
+	QObject::connect(_matrix, SIGNAL(evLevel(int)), this, SLOT(onLevel(int)));
+}
+
+void Game::setAvatarHeight(qreal height)
+{
+	// Account for the view scaling graphics to the screen height
+	qreal k = (views().count()) ? views().first()->transform().m22() : 1.0f;
+
+	_inputSource->setAvatarHeight(qCeil(height * k));
+}
+
+void Game::setGestureMask(quint32 mask)
+{
+	// Sliders and circles hold their last value; one that stops reporting has to let go
+	quint32 removed = _inputSource->getGestureMask() & ~mask;
+
+	if (removed & (1 << InputEvent::EVENT_CIRCLE))
+	{
+		_inputManager->setState(InputManager::INPUT_L1, 0.0f);
+		_inputManager->setState(InputManager::INPUT_R1, 0.0f);
+	}
+	if (removed & (1 << InputEvent::EVENT_SLIDE_X))
+	{
+		_inputManager->setState(InputManager::INPUT_X1, 0.0f);
+	}
+	if (removed & (1 << InputEvent::EVENT_SLIDE_Y))
+	{
+		_inputManager->setState(InputManager::INPUT_Y1, 0.0f);
+	}
+	if (removed & (1 << InputEvent::EVENT_SLIDE_Z))
+	{
+		_inputManager->setState(InputManager::INPUT_Z1, 0.0f);
+	}
+
+	_inputSource->setGestureMask(mask);
+}
+
+Game::State Game::getState() const
+{
+	return _state;
+}
+
+void Game::setState(State state)
+{
+	_s1 = state;
+}
+
+void Game::updateHand()
+{
+	// Only the latest position matters
+	InputSource::HandPoint point;
+	bool updated = false;
+	while (_inputSource->takeHandPoint(point))
+	{
+		updated = true;
+	}
+
+	if ((!updated)
+		|| (!_inputManager))
+	{
+		return;
+	}
+
+	// Centered where the hand was first seen, dragged along past either end
+	qreal half = HAND_RANGE * 0.5f;
+	if (!_handAnchored)
+	{
+		_handAnchored = true;
+		_handAnchor = point.position[0];
+	}
+
+	qreal d = point.position[0] - _handAnchor;
+	if (d > half)
+	{
+		_handAnchor += d - half;
+		d = half;
+	}
+	else if (d < -half)
+	{
+		_handAnchor += d + half;
+		d = -half;
+	}
+
+	_inputManager->setState(InputManager::INPUT_X0, d / half);
+}
+
+void Game::updateInput()
+{
+	// Gestures arrive a frame at a time, taken once per tick rather than as
+	// separately queued signals
+	LatencyTracer* tracer = LatencyTracer::instance();
+
+	InputSource::Packet packet;
+	while (_inputSource->takePacket(packet))
+	{
+		tracer->begin(packet.timestamp, packet.captured, packet.time);
+
+		for (int i = 0; i < packet.eventCount; ++i)
+		{
+			onInputEvent(packet.events[i]);
+		}
+	}
+
+	tracer->setTrace(0);
+}
+
+void Game::update(qreal dt)
+{
+	if (_state != _s1)
+	{
+		onStateLeave(_state);
+		_state = _s1;
+		onStateEnter(_state);
+	}
+
+	updateHand();
+	updateInput();
+
+	if (!_state)
+	{
+		setState(STATE_INIT);
+	}
+	else if (_state == STATE_INIT)
+	{
+	}
+	else if (_state == STATE_HOME)
+	{
+		_background->update(dt);
+		_homeScreen->update(dt);
+
+		_inputManager->update(dt);
+
+		_player->update(dt);
+	}
+	else if (_state == STATE_PLAY)
+	{
+		_background->update(dt);
+		_playScreen->update(dt);
+
+		// 1. Game state is created/updated
+		// 2. Visual is updated
+		// 3. In-between frames
+		// 4. Player reacts to visual
+
+		// Freeze input reacting to previous frame
+		_inputManager->update(dt);
+
+		// Player processing
+		// Apply input or AI
+		_player->update(dt);
+
+		// Update game state
+		_matrix->update(dt);
+	}
+	else if (_state == STATE_MENU)
+	{
+		_menuScreen->update(dt);
+
+		_inputManager->update(dt);
+
+		_player->update(dt);
+	}
+	else if (_state == STATE_QUIT)
+	{
+		_quitScreen->update(dt);
+
+		_inputManager->update(dt);
+
+		_player->update(dt);
+	}
+}
+
+void Game::onStateEnter(State state)
+{
+	if (!state)
+	{
+	}
+	else if (state == STATE_INIT)
+	{
+		initSprite();
+		initEffect();
+
+		initPlayer();
+
+		_inputSource->start();
+
+		setState(STATE_HOME);
+	}
+	else if (state == STATE_HOME)
+	{
+		_quitScreen->hide();
+		_menuScreen->hide();
+		_playScreen->hide();
+		_homeScreen->show();
+
+		initMatrix();
+
+		setAvatarHeight(_homeScreen->getAvatarHeight());
+
+		_player->setState(Player::STATE_HOME);
+
+		// Wave to play
+		setGestureMask(1 << InputEvent::EVENT_WAVE);
+		_inputSource->setOutputs(InputSource::OUTPUT_AVATAR);
+
+		_background->setSpeed(_matrix->getLevel());
+	}
+	else if (state == STATE_PLAY)
+	{
+		_quitScreen->hide();
+		_menuScreen->hide();
+		_homeScreen->hide();
+		_playScreen->show();
+
+		setAvatarHeight(_matrix->getAvatarHeight());
+
+		_player->setState(Player::STATE_PLAY);
+
+		// Everything Player moves the tetromino with, and wave once it is over
+		quint32 mask = (1 << InputEvent::EVENT_CIRCLE)
+			| (1 << InputEvent::EVENT_SLIDE_Y)
+			| (1 << InputEvent::EVENT_SLIDE_Z)
+			| (1 << InputEvent::EVENT_SWIPE_Y)
+			| (1 << InputEvent::EVENT_WAVE);
+		if (_player->getControl() != Player::CONTROL_DIRECT)
+			mask |= (1 << InputEvent::EVENT_SLIDE_X);
+		setGestureMask(mask);
+		_inputSource->setOutputs((_player->getControl() == Player::CONTROL_DIRECT)
+			? InputSource::OUTPUT_AVATAR | InputSource::OUTPUT_HAND
+			: InputSource::OUTPUT_AVATAR);
+	}
+	else if (state == STATE_MENU)
+	{
+		_quitScreen->hide();
+		_menuScreen->show();
+
+		_player->setState(Player::STATE_MENU);
+
+		// Wave to continue, with the avatar out of sight
+		setGestureMask(1 << InputEvent::EVENT_WAVE);
+		_inputSource->setOutputs(InputSource::OUTPUT_NONE);
+	}
+	else if (state == STATE_QUIT)
+	{
+		_quitScreen->show();
+
+		_player->setState(Player::STATE_QUIT);
+
+		// Slide and swipe left to quit, right to play on, or wave
+		setGestureMask((1 << InputEvent::EVENT_SLIDE_X)
+			| (1 << InputEvent::EVENT_SWIPE_X)
+			| (1 << InputEvent::EVENT_WAVE));
+		_inputSource->setOutputs(InputSource::OUTPUT_NONE);
+	}
+}
+
+void Game::onStateLeave(State state)
+{
+	if (!state)
+	{
+	}
+	else if (state == STATE_INIT)
+	{
+	}
+	else if (state == STATE_HOME)
+	{
+	}
+	else if (state == STATE_PLAY)
+	{
+	}
+	else if (state == STATE_MENU)
+	{
+	}
+	else if (state == STATE_QUIT)
+	{
+	}
+}
+
+void Game::onInputEvent(const InputEvent& event)
+{
+	const float* v = event.value;
+
+	if (!event.type)
+	{
+	}
+	else if (event.type == InputEvent::EVENT_USER_ENTER)
+	{
+		onUserEnter();
+	}
+	else if (event.type == InputEvent::EVENT_USER_LEAVE)
+	{
+		onUserLeave();
+	}
+	else if (event.type == InputEvent::EVENT_SESSION_BEGIN)
+	{
+		onSessionBegin();
+	}
+	else if (event.type == InputEvent::EVENT_SESSION_END)
+	{
+		onSessionEnd();
+	}
+	else if (event.type == InputEvent::EVENT_FOCUS_GAIN)
+	{
+		onFocusGain();
+	}
+	else if (event.type == InputEvent::EVENT_FOCUS_LOSE)
+	{
+		onFocusLose();
+	}
+	else if (event.type == InputEvent::EVENT_FOCUS_SWAP)
+	{
+		onFocusSwap();
+	}
+	else if (event.type == InputEvent::EVENT_FOCUS_MOVE)
+	{
+		// Taken from the hand points instead, see updateHand
+	}
+	else if (event.type == InputEvent::EVENT_STEADY_BEGIN)
+	{
+		onSteadyBegin();
+	}
+	else if (event.type == InputEvent::EVENT_STEADY_END)
+	{
+		onSteadyEnd();
+	}
+	else if (event.type == InputEvent::EVENT_CIRCLE)
+	{
+		onCircle(static_cast<int>(v[0]));
+	}
+	else if (event.type == InputEvent::EVENT_SLIDE_X)
+	{
+		onSlideX(v[0]);
+	}
+	else if (event.type == InputEvent::EVENT_SLIDE_Y)
+	{
+		onSlideY(v[0]);
+	}
+	else if (event.type == InputEvent::EVENT_SLIDE_Z)
+	{
+		onSlideZ(v[0]);
+	}
+	else if (event.type == InputEvent::EVENT_SWIPE_X)
+	{
+		onSwipeX(static_cast<int>(v[0]), v[1], v[2]);
+	}
+	else if (event.type == InputEvent::EVENT_SWIPE_Y)
+	{
+		onSwipeY(static_cast<int>(v[0]), v[1], v[2]);
+	}
+	else if (event.type == InputEvent::EVENT_PUSH)
+	{
+		onPush(v[0], v[1]);
+	}
+	else if (event.type == InputEvent::EVENT_WAVE)
+	{
+		onWave();
+	}
+}
+
+void Game::timerEvent(QTimerEvent* event)
+{
+	if (event->timerId() == _timer)
+	{
+		qint64 t = QDateTime::currentMSecsSinceEpoch();
+		// Game time runs faster at higher rates, or a full step per update if rate is 0
+		int dt = (_rate > 0.0f)
+			? qMin<qreal>(UPDATE_INTERVAL, (t - _t0) * _rate)
+			: UPDATE_INTERVAL;
+		update(dt);
+		_t0 = t;
+	}
+	else
+	{
+		QGraphicsScene::timerEvent(event);
+	}
+}
+
+void Game::drawForeground(QPainter* painter, const QRectF& rect)
+{
+	QGraphicsScene::drawForeground(painter, rect);
+
+	// Whatever the matrix moved is on screen now
+	LatencyTracer::instance()->present();
+}
+
+void Game::keyPressEvent(QKeyEvent* event)
+{
+	if (event->key() == Qt::Key_F5)
+	{
+		// Switch the avatar between color and depth, without reconnecting
+		SensorThread* sensorThread = qobject_cast<SensorThread*>(_inputSource);
+		if (sensorThread)
+			sensorThread->setDepthOnly(!sensorThread->getDepthOnly());
+	}
+	else if (event->key() == Qt::Key_F6)
+	{
+		// Next of the modes the sensor supports, without reconnecting
+		SensorThread* sensorThread = qobject_cast<SensorThread*>(_inputSource);
+		if (sensorThread)
+		{
+			QVector<XnMapOutputMode> modes = sensorThread->getCaptureModes();
+			XnMapOutputMode mode = sensorThread->getCaptureMode();
+
+			int next = 0;
+			for (int i = 0, il = modes.count(); i < il; ++i)
+			{
+				if (SensorThread::isEqual(modes[i], mode))
+				{
+					next = (i + 1) % il;
+					break;
+				}
+			}
+
+			if (modes.count())
+				sensorThread->setCaptureMode(modes[next]);
+		}
+	}
+	else if (event->key() == Qt::Key_F12)
+	{
+		LatencyTracer* tracer = LatencyTracer::instance();
+		if (tracer->isEnabled())
+			tracer->save();
+	}
+
+	if (!_state)
+	{
+	}
+	else if (_state == STATE_INIT)
+	{
+	}
+	else if (_state == STATE_HOME)
+	{
+		if (event->key() == Qt::Key_Escape)
+		{
+			_inputManager->setState(InputManager::INPUT_PLAY, 1.0f, true);
+
+			setState(Game::STATE_PLAY);
+		}
+	}
+	else if (_state == STATE_PLAY)
+	{
+		if (event->key() == Qt::Key_Escape)
+		{
+			_inputManager->setState(InputManager::INPUT_PLAY, 1.0f, true);
+
+			if (static_cast<Matrix*>(_matrix)->getState() == Matrix::STATE_OVER)
+				setState(STATE_HOME);
+			else
+				setState(STATE_MENU);
+		}
+	}
+	else if (_state == STATE_MENU)
+	{
+		if (event->key() == Qt::Key_Escape)
+		{
+			_inputManager->setState(InputManager::INPUT_PLAY, 1.0f, true);
+
+			setState(Game::STATE_PLAY);
+		}
+	}
+	else if (_state == STATE_QUIT)
+	{
+		if (event->key() == Qt::Key_Escape)
+		{
+			_inputManager->setState(InputManager::INPUT_PLAY, 1.0f, true);
+
+			setState(Game::STATE_PLAY);
+		}
+	}
+
+	QGraphicsScene::keyPressEvent(event);
+}
+
+void Game::keyReleaseEvent(QKeyEvent* event)
+{
+	if (!_state)
+	{
+	}
+	else if (_state == STATE_INIT)
+	{
+	}
+	else if (_state == STATE_HOME)
+	{
+		//
+	}
+	else if (_state == STATE_PLAY)
+	{
+		//
+	}
+	else if (_state == STATE_MENU)
+	{
+		//
+	}
+	else if (_state == STATE_QUIT)
+	{
+		//
+	}
+
+	QGraphicsScene::keyReleaseEvent(event);
+}
+
+void Game::onConnectBegin()
+{
+	if (!_state)
+	{
+	}
+	else if (_state == STATE_INIT)
+	{
+	}
+	else if (_state == STATE_HOME)
+	{
+		_homeScreen->setStatus(tr("Connecting to sensor..."));
+	}
+	else if (_state == STATE_PLAY)
+	{
+	}
+	else if (_state == STATE_MENU)
+	{
+	}
+	else if (_state == STATE_QUIT)
+	{
+	}
+}
+
+void Game::onConnectError()
+{
+	if (!_state)
+	{
+	}
+	else if (_state == STATE_INIT)
+	{
+	}
+	else if (_state == STATE_HOME)
+	{
+		_homeScreen->setStatus(tr("Unable to connect to sensor."));
+	}
+	else if (_state == STATE_PLAY)
+	{
+	}
+	else if (_state == STATE_MENU)
+	{
+	}
+	else if (_state == STATE_QUIT)
+	{
+	}
+}
+
+void Game::onConnect()
+{
+	if (!_state)
+	{
+	}
+	else if (_state == STATE_INIT)
+	{
+	}
+	else if (_state == STATE_HOME)
+	{
+		_homeScreen->setStatus(tr("Detecting player... (Please step back from the sensor.)"));
+	}
+	else if (_state == STATE_PLAY)
+	{
+	}
+	else if (_state == STATE_MENU)
+	{
+		_menuScreen->setStatus(tr("Wave to continue."));
+	}
+	else if (_state == STATE_QUIT)
+	{
+	}
+}
+
+void Game::onDisconnect()
+{
+	if (!_state)
+	{
+	}
+	else if (_state == STATE_INIT)
+	{
+	}
+	else if (_state == STATE_HOME)
+	{
+		_homeScreen->setStatus(tr("Lost connection to sensor."));
+	}
+	else if (_state == STATE_PLAY)
+	{
+		_menuScreen->setStatus(tr("Lost connection to sensor. Reconnecting..."));
+		setState(STATE_MENU);
+	}
+	else if (_state == STATE_MENU)
+	{
+		_menuScreen->setStatus(tr("Lost connection to sensor. Reconnecting..."));
+	}
+	else if (_state == STATE_QUIT)
+	{
+		_menuScreen->setStatus(tr("Lost connection to sensor. Reconnecting..."));
+		setState(STATE_MENU);
+	}
+}
+
+void Game::onUserEnter()
+{
+	if (!_state)
+	{
+	}
+	else if (_state == STATE_INIT)
+	{
+	}
+	else if (_state == STATE_HOME)
+	{
+		_homeScreen->setStatus(tr("Wave to start."));
+	}
+	else if (_state == STATE_PLAY)
+	{
+	}
+	else if (_state == STATE_MENU)
+	{
+	}
+	else if (_state == STATE_QUIT)
+	{
+	}
+}
+
+void Game::onUserLeave()
+{
+	if (!_state)
+	{
+	}
+	else if (_state == STATE_INIT)
+	{
+	}
+	else if (_state == STATE_HOME)
+	{
+	}
+	else if (_state == STATE_PLAY)
+	{
+	}
+	else if (_state == STATE_MENU)
+	{
+	}
+	else if (_state == STATE_QUIT)
+	{
+	}
+}
+
+void Game::onSessionBegin()
+{
+	if (!_state)
+	{
+	}
+	else if (_state == STATE_INIT)
+	{
+	}
+	else if (_state == STATE_HOME)
+	{
+		setState(Game::STATE_PLAY);
+	}
+	else if (_state == STATE_PLAY)
+	{
+	}
+	else if (_state == STATE_MENU)
+	{
+		setState(Game::STATE_PLAY);
+	}
+	else if (_state == STATE_QUIT)
+	{
+	}
+}
+
+void Game::onSessionEnd()
+{
+	if (!_state)
+	{
+	}
+	else if (_state == STATE_INIT)
+	{
+	}
+	else if (_state == STATE_HOME)
+	{
+		_homeScreen->setStatus(tr("Wave to start."));
+	}
+	else if (_state == STATE_PLAY)
+	{
+		_menuScreen->setStatus(tr("Wave to continue."));
+		setState(STATE_MENU);
+	}
+	else if (_state == STATE_MENU)
+	{
+	}
+	else if (_state == STATE_QUIT)
+	{
+		_menuScreen->setStatus(tr("Wave to continue."));
+		setState(STATE_MENU);
+	}
+}
+
+void Game::onFocusGain()
+{
+	qDebug() << "FocusGain";
+
+	_handAnchored = false;
+
+	if (!_state)
+	{
+	}
+	else if (_state == STATE_INIT)
+	{
+	}
+	else if (_state == STATE_HOME)
+	{
+	}
+	else if (_state == STATE_PLAY)
+	{
+		//
+	}
+	else if (_state == STATE_MENU)
+	{
+		//
+	}
+	else if (_state == STATE_QUIT)
+	{
+		//
+	}
+}
+
+void Game::onFocusLose()
+{
+	qDebug() << "FocusLose";
+
+	if (!_state)
+	{
+	}
+	else if (_state == STATE_INIT)
+	{
+	}
+	else if (_state == STATE_HOME)
+	{
+	}
+	else if (_state == STATE_PLAY)
+	{
+		//
+	}
+	else if (_state == STATE_MENU)
+	{
+		//
+	}
+	else if (_state == STATE_QUIT)
+	{
+		//
+	}
+}
+
+void Game::onFocusSwap()
+{
+}
+
+void Game::onSteadyBegin()
+{
+	_inputManager->setState(InputManager::INPUT_NONE, 1.0f);
+}
+
+void Game::onSteadyEnd()
+{
+	_inputManager->setState(InputManager::INPUT_NONE, 0.0f);
+}
+
+void Game::onCircle(int direction)
+{
+	if (!direction)
+	{
+		_inputManager->setState(InputManager::INPUT_L1, 0.0f, true);
+		_inputManager->setState(InputManager::INPUT_R1, 0.0f, true);
+	}
+	else if (direction < 0)
+	{
+		_inputManager->setState(InputManager::INPUT_L1, 1.0f, true);
+	}
+	else if (direction > 0)
+	{
+		_inputManager->setState(InputManager::INPUT_R1, 1.0f, true);
+	}
+}
+
+void Game::onSlideX(qreal direction)
+{
+	_inputManager->setState(InputManager::INPUT_X1, direction);
+}
+
+void Game::onSlideY(qreal direction)
+{
+	_inputManager->setState(InputManager::INPUT_Y1, direction);
+}
+
+void Game::onSlideZ(qreal direction)
+{
+	_inputManager->setState(InputManager::INPUT_Z1, -direction);
+}
+
+void Game::onSwipeX(int direction, qreal speed, qreal angle)
+{
+	// Prevent "unreferenced formal parameter" warning
+	speed;
+	angle;
+
+	_inputManager->setState(InputManager::INPUT_X2, direction, true);
+}
+
+void Game::onSwipeY(int direction, qreal speed, qreal angle)
+{
+	// Prevent "unreferenced formal parameter" warning
+	speed;
+	angle;
+
+	_inputManager->setState(InputManager::INPUT_Y2, direction, true);
+}
+
+void Game::onPush(qreal speed, qreal angle)
+{
+	// Prevent "unreferenced formal parameter" warning
+	speed;
+	angle;
+
+	_inputManager->setState(InputManager::INPUT_Z2, 1.0f, true);
+}
+
+void Game::onWave()
+{
+	_inputManager->setState(InputManager::INPUT_PLAY, 1.0f, true);
+
+	if (!_state)
+	{
+	}
+	else if (_state == STATE_INIT)
+	{
+	}
+	else if (_state == STATE_HOME)
+	{
+	}
+	else if (_state == STATE_PLAY)
+	{
+		if (static_cast<Matrix*>(_matrix)->getState() == Matrix::STATE_OVER)
+			setState(STATE_HOME);
+//		else
+//			setState(STATE_MENU);
+	}
+	else if (_state == STATE_MENU)
+	{
+		setState(STATE_PLAY);
+	}
+	else if (_state == STATE_QUIT)
+	{
+		setState(STATE_PLAY);
+	}
+}
+
+void Game::onUsersMap(QImage image, QPoint offset, QSize size)
+{
+	if (!_state)
+	{
+	}
+	else if (_state == STATE_INIT)
+	{
+	}
+	else if (_state == STATE_HOME)
+	{
+		_homeScreen->setAvatar(QPixmap::fromImage(image), offset, size);
+	}
+	else if (_state == STATE_PLAY)
+	{
+		_matrix->setAvatar(QPixmap::fromImage(image), offset, size);
+	}
+	else if (_state == STATE_MENU)
+	{
+	}
+	else if (_state == STATE_QUIT)
+	{
+	}
+}
+
+void Game::onLevel(int count)
+{
+	// Prevent "unreferenced formal parameter" warning
+	count;
+
+	_background->setSpeed(_matrix->getRules()->getSpeed(_matrix->getLevel()));
+}
+
+void Game::onPlay()
+{
+	setState(STATE_PLAY);
+}
+
+void Game::onQuit(bool force)
+{
+	if (force)
+		QApplication::closeAllWindows();
+	else
+		setState(STATE_QUIT);
+}
@@ -0,0 +1,294 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GestureRecognizer.h"
+
+#include <math.h>
+
+const float GestureRecognizer::SLIDE_STEP = 0.01f;
+
+GestureRecognizer::Config::Config()
+{
+	// Same as the NITE detectors in SensorThread, with windows a fraction as long
+	slideSize = 150.0f; // mm
+
+	swipeWindow = 100; // ms
+	swipeCooldown = 250; // ms
+	swipeSpeed = 0.4f; // m/sec
+	swipeAngleX = 25.0f; // deg
+	swipeAngleY = 20.0f; // deg
+
+	pushSpeed = 0.33f; // m/sec
+	pushAngle = 30.0f; // deg
+
+	circleWindow = 250; // ms
+	circleRadius = 40.0f; // mm
+	circleTurn = 0.75f; // revolutions
+}
+
+GestureRecognizer::GestureRecognizer()
+{
+	init();
+}
+
+GestureRecognizer::~GestureRecognizer()
+{
+}
+
+void GestureRecognizer::init()
+{
+	reset();
+}
+
+const GestureRecognizer::Config& GestureRecognizer::getConfig() const
+{
+	return _config;
+}
+
+void GestureRecognizer::setConfig(const Config& config)
+{
+	_config = config;
+}
+
+void GestureRecognizer::reset()
+{
+	_historyIndex = 0;
+	_historyCount = 0;
+
+	for (int i = 0; i < 3; ++i)
+	{
+		_slideAnchor[i] = 0.0f;
+		_slide[i] = 0.0f;
+	}
+
+	_swipeTimestamp = 0;
+
+	_circleCenter[0] = 0.0f;
+	_circleCenter[1] = 0.0f;
+	_circleAngle = 0.0f;
+	_circleTurn = 0.0f;
+	_circle = false;
+}
+
+void GestureRecognizer::update(const float position[3], quint64 timestamp, QVector<InputEvent>& events)
+{
+	const Sample& previous = _history[_historyIndex];
+
+	// Ignore repeated points, e.g. more than one update per frame
+	if ((_historyCount)
+		&& (timestamp <= previous.timestamp))
+	{
+		return;
+	}
+
+	_historyIndex = (_historyIndex + 1) % HISTORY;
+	if (_historyCount < HISTORY)
+		++_historyCount;
+
+	Sample& sample = _history[_historyIndex];
+	sample.timestamp = timestamp;
+	sample.position[0] = position[0];
+	sample.position[1] = position[1];
+	sample.position[2] = position[2];
+
+	// First point is where sliders are centered
+	if (_historyCount == 1)
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			_slideAnchor[i] = position[i];
+		}
+
+		_circleCenter[0] = position[0];
+		_circleCenter[1] = position[1];
+		return;
+	}
+
+	updateSlide(sample, events);
+	updateSwipe(sample, events);
+	updateCircle(sample, _history[(_historyIndex + HISTORY - 1) % HISTORY], events);
+}
+
+const GestureRecognizer::Sample* GestureRecognizer::getSample(quint64 timestamp) const
+{
+	// Oldest sample no older than the given time
+	const Sample* sample = NULL;
+
+	for (int i = 0; i < _historyCount; ++i)
+	{
+		const Sample& s = _history[(_historyIndex + HISTORY - i) % HISTORY];
+		if (s.timestamp < timestamp)
+			break;
+
+		sample = &s;
+	}
+
+	return sample;
+}
+
+void GestureRecognizer::updateSlide(const Sample& sample, QVector<InputEvent>& events)
+{
+	static const InputEvent::Type TYPE[3] = {
+		InputEvent::EVENT_SLIDE_X,
+		InputEvent::EVENT_SLIDE_Y,
+		InputEvent::EVENT_SLIDE_Z
+	};
+
+	float half = _config.slideSize * 0.5f;
+
+	for (int i = 0; i < 3; ++i)
+	{
+		// Drag the slider along when the hand goes past its ends, so that it
+		// responds as soon as the hand comes back
+		float d = sample.position[i] - _slideAnchor[i];
+		if (d > half)
+		{
+			_slideAnchor[i] += d - half;
+			d = half;
+		}
+		else if (d < -half)
+		{
+			_slideAnchor[i] += d + half;
+			d = -half;
+		}
+
+		float value = d / half;
+
+		if ((qAbs(value - _slide[i]) >= SLIDE_STEP)
+			|| ((qAbs(value) == 1.0f) && (value != _slide[i])))
+		{
+			_slide[i] = value;
+
+			InputEvent event = {TYPE[i], {value, 0.0f, 0.0f}};
+			events << event;
+		}
+	}
+}
+
+void GestureRecognizer::updateSwipe(const Sample& sample, QVector<InputEvent>& events)
+{
+	if ((_swipeTimestamp)
+		&& (sample.timestamp < _swipeTimestamp + _config.swipeCooldown * 1000))
+	{
+		return;
+	}
+
+	quint64 window = _config.swipeWindow * 1000; // usec
+	const Sample* start = getSample((sample.timestamp > window) ? sample.timestamp - window : 0);
+	if (!start)
+		return;
+
+	// Need most of the window to tell a swipe from jitter
+	qint64 dt = (sample.timestamp - start->timestamp) / 1000; // ms
+	if (dt < _config.swipeWindow / 2)
+		return;
+
+	// mm/ms is m/sec
+	float vx = (sample.position[0] - start->position[0]) / dt;
+	float vy = (sample.position[1] - start->position[1]) / dt;
+	float vz = (sample.position[2] - start->position[2]) / dt;
+
+	float ax = qAbs(vx);
+	float ay = qAbs(vy);
+	float az = qAbs(vz);
+
+	static const float DEG = 180.0f / 3.14159265f;
+
+	if ((ax >= _config.swipeSpeed)
+		&& (atan2f(sqrtf(ay * ay + az * az), ax) * DEG <= _config.swipeAngleX))
+	{
+		InputEvent event = {InputEvent::EVENT_SWIPE_X, {(vx < 0.0f) ? -1.0f : 1.0f, ax, atan2f(vy, ax) * DEG}};
+		events << event;
+
+		_swipeTimestamp = sample.timestamp;
+	}
+	else if ((ay >= _config.swipeSpeed)
+		&& (atan2f(sqrtf(ax * ax + az * az), ay) * DEG <= _config.swipeAngleY))
+	{
+		InputEvent event = {InputEvent::EVENT_SWIPE_Y, {(vy < 0.0f) ? -1.0f : 1.0f, ay, atan2f(vx, ay) * DEG}};
+		events << event;
+
+		_swipeTimestamp = sample.timestamp;
+	}
+	else if ((vz <= -_config.pushSpeed)
+		&& (atan2f(sqrtf(ax * ax + ay * ay), az) * DEG <= _config.pushAngle))
+	{
+		// Towards the sensor
+		InputEvent event = {InputEvent::EVENT_PUSH, {az, atan2f(sqrtf(ax * ax + ay * ay), az) * DEG, 0.0f}};
+		events << event;
+
+		_swipeTimestamp = sample.timestamp;
+	}
+}
+
+void GestureRecognizer::updateCircle(const Sample& sample, const Sample& previous, QVector<InputEvent>& events)
+{
+	static const float TWO_PI = 2.0f * 3.14159265f;
+
+	// Center follows the hand slowly, so that it settles in the middle of a circle
+	qint64 dt = (sample.timestamp - previous.timestamp) / 1000; // ms
+	float k = qMin(1.0f, dt / static_cast<float>(qMax<qint64>(1, _config.circleWindow)));
+
+	_circleCenter[0] += (sample.position[0] - _circleCenter[0]) * k;
+	_circleCenter[1] += (sample.position[1] - _circleCenter[1]) * k;
+
+	float rx = sample.position[0] - _circleCenter[0];
+	float ry = sample.position[1] - _circleCenter[1];
+
+	if (rx * rx + ry * ry < _config.circleRadius * _config.circleRadius)
+	{
+		_circle = false;
+		_circleTurn = 0.0f;
+		return;
+	}
+
+	float angle = atan2f(ry, rx);
+
+	if (_circle)
+	{
+		float d = angle - _circleAngle;
+		if (d > TWO_PI * 0.5f)
+			d -= TWO_PI;
+		else if (d < -TWO_PI * 0.5f)
+			d += TWO_PI;
+
+		_circleTurn += d;
+	}
+
+	_circle = true;
+	_circleAngle = angle;
+
+	// Clockwise is positive, like NITE
+	float turn = TWO_PI * _config.circleTurn;
+	if (_circleTurn <= -turn)
+	{
+		InputEvent event = {InputEvent::EVENT_CIRCLE, {1.0f, 0.0f, 0.0f}};
+		events << event;
+
+		_circleTurn += turn;
+	}
+	else if (_circleTurn >= turn)
+	{
+		InputEvent event = {InputEvent::EVENT_CIRCLE, {-1.0f, 0.0f, 0.0f}};
+		events << event;
+
+		_circleTurn -= turn;
+	}
+}
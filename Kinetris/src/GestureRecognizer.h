@@ -0,0 +1,101 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KINETRIS_GESTURERECOGNIZER_H
+#define KINETRIS_GESTURERECOGNIZER_H
+
+#include <QtCore/QtCore>
+
+#include "InputEvent.h"
+
+// Recognizes slides, swipes, circles and pushes from the primary hand point,
+// frame by frame, with much shorter windows than the NITE detectors; the
+// events it produces mean the same as theirs
+class GestureRecognizer
+{
+public:
+
+	struct Config
+	{
+		float slideSize; // mm
+
+		qint64 swipeWindow; // ms
+		qint64 swipeCooldown; // ms
+		float swipeSpeed; // m/sec
+		float swipeAngleX; // deg
+		float swipeAngleY; // deg
+
+		float pushSpeed; // m/sec
+		float pushAngle; // deg
+
+		qint64 circleWindow; // ms
+		float circleRadius; // mm
+		float circleTurn; // revolutions
+
+		Config();
+	};
+
+	GestureRecognizer();
+	virtual ~GestureRecognizer();
+
+	const Config& getConfig() const;
+	void setConfig(const Config& config);
+
+	void reset();
+	void update(const float position[3], quint64 timestamp, QVector<InputEvent>& events);
+
+protected:
+
+	struct Sample
+	{
+		quint64 timestamp; // usec
+		float position[3]; // mm
+	};
+
+	static const int HISTORY = 32; // samples
+
+	static const float SLIDE_STEP;
+
+	Config _config;
+
+	Sample _history[HISTORY];
+	int _historyIndex;
+	int _historyCount;
+
+	float _slideAnchor[3]; // mm
+	float _slide[3];
+
+	quint64 _swipeTimestamp; // usec
+
+	float _circleCenter[2]; // mm
+	float _circleAngle; // rad
+	float _circleTurn; // rad
+	bool _circle;
+
+	void init();
+
+	const Sample* getSample(quint64 timestamp) const;
+
+	void updateSlide(const Sample& sample, QVector<InputEvent>& events);
+	void updateSwipe(const Sample& sample, QVector<InputEvent>& events);
+	void updateCircle(const Sample& sample, const Sample& previous, QVector<InputEvent>& events);
+};
+
+#endif // KINETRIS_GESTURERECOGNIZER_H
@@ -0,0 +1,123 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "HandFilter.h"
+
+#include <math.h>
+
+HandFilter::Config::Config()
+{
+	minCutoff = 1.0f; // Hz
+	beta = 0.01f; // Hz per mm/sec
+	derivativeCutoff = 1.0f; // Hz
+	prediction = 1.0f / 30.0f; // sec
+}
+
+HandFilter::HandFilter()
+{
+	init();
+}
+
+HandFilter::~HandFilter()
+{
+}
+
+void HandFilter::init()
+{
+	reset();
+}
+
+const HandFilter::Config& HandFilter::getConfig() const
+{
+	return _config;
+}
+
+void HandFilter::setConfig(const Config& config)
+{
+	_config = config;
+}
+
+void HandFilter::reset()
+{
+	_filtered = false;
+	_timestamp = 0;
+
+	for (int i = 0; i < 3; ++i)
+	{
+		_position[i] = 0.0f;
+		_velocity[i] = 0.0f;
+	}
+}
+
+void HandFilter::update(float position[3], quint64 timestamp)
+{
+	if ((!_filtered)
+		|| (timestamp <= _timestamp))
+	{
+		// First point, or time went backwards, e.g. playback starting over
+		if ((!_filtered)
+			|| (timestamp < _timestamp))
+		{
+			_filtered = true;
+			_timestamp = timestamp;
+
+			for (int i = 0; i < 3; ++i)
+			{
+				_position[i] = position[i];
+				_velocity[i] = 0.0f;
+			}
+		}
+	}
+	else
+	{
+		float dt = (timestamp - _timestamp) / 1000000.0f; // sec
+		_timestamp = timestamp;
+
+		// Speed decides how much to smooth; the faster, the higher the cutoff
+		float a = getAlpha(_config.derivativeCutoff, dt);
+		float speed = 0.0f;
+
+		for (int i = 0; i < 3; ++i)
+		{
+			float v = (position[i] - _position[i]) / dt;
+			_velocity[i] += (v - _velocity[i]) * a;
+			speed += _velocity[i] * _velocity[i];
+		}
+
+		a = getAlpha(_config.minCutoff + _config.beta * sqrtf(speed), dt);
+
+		for (int i = 0; i < 3; ++i)
+		{
+			_position[i] += (position[i] - _position[i]) * a;
+		}
+	}
+
+	for (int i = 0; i < 3; ++i)
+	{
+		position[i] = _position[i] + _velocity[i] * _config.prediction;
+	}
+}
+
+float HandFilter::getAlpha(float cutoff, float dt)
+{
+	float tau = 1.0f / (2.0f * 3.14159265f * cutoff);
+
+	return 1.0f / (1.0f + tau / dt);
+}
@@ -0,0 +1,66 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KINETRIS_HANDFILTER_H
+#define KINETRIS_HANDFILTER_H
+
+#include <QtCore/QtCore>
+
+// One Euro filter for the hand point: smooths jitter heavily while the hand is
+// still, and barely at all while it moves fast, so it adds little lag where it
+// matters; then predicts a little ahead to make up for the rest
+class HandFilter
+{
+public:
+
+	struct Config
+	{
+		float minCutoff; // Hz
+		float beta; // Hz per mm/sec
+		float derivativeCutoff; // Hz
+		float prediction; // sec
+
+		Config();
+	};
+
+	HandFilter();
+	virtual ~HandFilter();
+
+	const Config& getConfig() const;
+	void setConfig(const Config& config);
+
+	void reset();
+	void update(float position[3], quint64 timestamp);
+
+protected:
+
+	Config _config;
+
+	bool _filtered;
+	quint64 _timestamp; // usec
+	float _position[3]; // mm
+	float _velocity[3]; // mm/sec
+
+	void init();
+
+	static float getAlpha(float cutoff, float dt);
+};
+
+#endif // KINETRIS_HANDFILTER_H
@@ -1,79 +1,91 @@
-/**
- * This file is part of Kinetris.
- * 
- * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
- * Contact: Conan Chen <http://conanchen.com/>
- * 
- * This program is free software: you can redistribute it and/or modify
- * it under the terms of the GNU General Public License as published by
- * the Free Software Foundation, either version 3 of the License, or
- * (at your option) any later version.
- * 
- * This program is distributed in the hope that it will be useful,
- * but WITHOUT ANY WARRANTY; without even the implied warranty of
- * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- * GNU General Public License for more details.
- * 
- * You should have received a copy of the GNU General Public License
- * along with this program.  If not, see <http://www.gnu.org/licenses/>.
- */
-
-#ifndef KINETRIS_HOMESCREEN_H
-#define KINETRIS_HOMESCREEN_H
-
-#include <QtGui/QtGui>
-
-class Game;
-
-class HomeScreen : public QObject
-{
-	Q_OBJECT
-
-public:
-
-	HomeScreen(Game* parent);
-	virtual ~HomeScreen();
-
-	QGraphicsWidget* getSprite() const;
-
-	QString getStatus() const;
-	void setStatus(const QString& status);
-
-	void setAvatar(QPixmap pixmap);
-
-	void show();
-	void hide();
-
-	void update(qreal dt);
-
-protected:
-
-	static const char IMAGE_TITLE[];
-
-	static const qreal BACKGROUND_W; // px
-	static const qreal BACKGROUND_H; // px
-
-	static const qreal SHOWEFFECT_DURATION; // sec
-	static const qreal HIDEEFFECT_DURATION; // sec
-
-	static const qreal GLOWEFFECT_DURATION; // sec
-
-	QGraphicsWidget* _sprite;
-	QGraphicsProxyWidget* _sprite_status;
-
-	QLabel* _status;
-	QString _s1;
-
-	QGraphicsPixmapItem* _avatar;
-
-	QTimeLine* _showEffectTimer;
-	QTimeLine* _hideEffectTimer;
-
-	qreal _glowTimer; // ms
-
-	void init();
-	void initSprite();
-	void initEffect();
-};
-
-#endif // KINETRIS_HOMESCREEN_H
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KINETRIS_HOMESCREEN_H
+#define KINETRIS_HOMESCREEN_H
+
+#include <QtGui/QtGui>
+
+class Game;
+
+class HomeScreen : public QObject
+{
+	Q_OBJECT
+
+public:
+
+	HomeScreen(Game* parent);
+	virtual ~HomeScreen();
+
+	static void initImages();
+
+	QGraphicsWidget* getSprite() const;
+
+	QString getStatus() const;
+	void setStatus(const QString& status);
+
+	qreal getAvatarHeight() const; // px
+	void setAvatar(QPixmap pixmap, QPoint offset, QSize size);
+
+	void show();
+	void hide();
+
+	void update(qreal dt);
+
+protected:
+
+	static const char IMAGE_TITLE[];
+
+	static int _image_title;
+
+	static const qreal BACKGROUND_W; // px
+	static const qreal BACKGROUND_H; // px
+
+	static const qreal AVATAR_H; // px
+
+	static const qreal SHOWEFFECT_DURATION; // sec
+	static const qreal HIDEEFFECT_DURATION; // sec
+
+	static const qreal GLOWEFFECT_DURATION; // sec
+
+	QGraphicsWidget* _sprite;
+	QGraphicsProxyWidget* _sprite_status;
+
+	QLabel* _status;
+	QString _s1;
+
+	QGraphicsPixmapItem* _avatar;
+	QGraphicsPixmapItem* _title;
+
+	QTimeLine* _showEffectTimer;
+	QTimeLine* _hideEffectTimer;
+
+	qreal _glowTimer; // ms
+
+	void init();
+	void initSprite();
+	void initEffect();
+
+protected slots:
+
+	void onImage(QString uri, QPixmap pixmap);
+};
+
+#endif // KINETRIS_HOMESCREEN_H
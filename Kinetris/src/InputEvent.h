@@ -0,0 +1,58 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KINETRIS_INPUTEVENT_H
+#define KINETRIS_INPUTEVENT_H
+
+#include <QtCore/QtCore>
+
+// Plain data, so that events can be copied between threads and written to or
+// mapped from a recording as-is
+struct InputEvent
+{
+	enum Type
+	{
+		EVENT_NONE = 0,
+		EVENT_USER_ENTER,
+		EVENT_USER_LEAVE,
+		EVENT_SESSION_BEGIN,
+		EVENT_SESSION_END,
+		EVENT_FOCUS_GAIN,
+		EVENT_FOCUS_LOSE,
+		EVENT_FOCUS_SWAP,
+		EVENT_FOCUS_MOVE, // x, y, z; mm
+		EVENT_STEADY_BEGIN,
+		EVENT_STEADY_END,
+		EVENT_CIRCLE, // direction
+		EVENT_SLIDE_X, // direction
+		EVENT_SLIDE_Y, // direction
+		EVENT_SLIDE_Z, // direction
+		EVENT_SWIPE_X, // direction, speed, angle
+		EVENT_SWIPE_Y, // direction, speed, angle
+		EVENT_PUSH, // speed, angle
+		EVENT_WAVE,
+		EVENT_
+	};
+
+	qint32 type;
+	float value[3];
+};
+
+#endif // KINETRIS_INPUTEVENT_H
@@ -0,0 +1,199 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "InputSource.h"
+
+InputSource::InputSource(QObject* parent)
+	: QThread(parent)
+{
+	init();
+}
+
+InputSource::~InputSource()
+{
+}
+
+void InputSource::init()
+{
+	_avatarHeight = 0;
+	_gestureMask = ~0u;
+	_outputs = OUTPUT_ALL;
+
+	_packet.timestamp = 0;
+	_packet.captured = 0;
+	_packet.time = 0;
+	_packet.eventCount = 0;
+	_packetFull = false;
+}
+
+int InputSource::getAvatarHeight() const
+{
+	QMutexLocker l(&_configMutex);
+
+	return _avatarHeight;
+}
+
+void InputSource::setAvatarHeight(int height)
+{
+	QMutexLocker l(&_configMutex);
+
+	_avatarHeight = height;
+}
+
+quint32 InputSource::getGestureMask() const
+{
+	QMutexLocker l(&_configMutex);
+
+	return _gestureMask;
+}
+
+void InputSource::setGestureMask(quint32 mask)
+{
+	QMutexLocker l(&_configMutex);
+
+	_gestureMask = mask;
+}
+
+int InputSource::getOutputs() const
+{
+	QMutexLocker l(&_configMutex);
+
+	return _outputs;
+}
+
+void InputSource::setOutputs(int outputs)
+{
+	QMutexLocker l(&_configMutex);
+
+	_outputs = outputs;
+}
+
+bool InputSource::takeHandPoint(HandPoint& point)
+{
+	return _handPoints.pop(point);
+}
+
+bool InputSource::takePacket(Packet& packet)
+{
+	return _packets.pop(packet);
+}
+
+void InputSource::publish(const HandPoint& point)
+{
+	if (!(getOutputs() & OUTPUT_HAND))
+		return;
+
+	// Drop points if the game thread stops taking them, rather than wait
+	_handPoints.push(point);
+}
+
+qreal InputSource::getAvatarScale(int yres) const
+{
+	int height = getAvatarHeight();
+
+	// Never scale up, only down to the size the avatar is displayed at
+	if ((height <= 0) || (height >= yres))
+		return 1.0f;
+
+	return height / static_cast<qreal>(yres);
+}
+
+bool InputSource::isGesture(qint32 type)
+{
+	return ((type >= InputEvent::EVENT_STEADY_BEGIN)
+		&& (type <= InputEvent::EVENT_WAVE));
+}
+
+void InputSource::dispatch(InputEvent::Type type, float a, float b, float c)
+{
+	InputEvent event = {type, {a, b, c}};
+
+	dispatch(event);
+}
+
+void InputSource::dispatch(const InputEvent& event)
+{
+	// The hand goes to the game through publish, every frame, never in a packet
+	if (event.type == InputEvent::EVENT_FOCUS_MOVE)
+		return;
+
+	// Only gestures the game needs right now, everything else always
+	if ((isGesture(event.type))
+		&& (!(getGestureMask() & (1 << event.type))))
+	{
+		return;
+	}
+
+	QMutexLocker l(&_packetMutex);
+
+	if (_packet.eventCount >= PACKET_EVENTS)
+	{
+		if (!_packetFull)
+		{
+			qWarning() << "Input packet full, dropping gestures until the game catches up";
+			_packetFull = true;
+		}
+
+		// Make room by dropping the oldest gesture; sessions and focus must get through
+		int i = 0;
+		while ((i < _packet.eventCount)
+			&& (!isGesture(_packet.events[i].type)))
+		{
+			++i;
+		}
+
+		if (i == _packet.eventCount)
+			return;
+
+		for (--_packet.eventCount; i < _packet.eventCount; ++i)
+		{
+			_packet.events[i] = _packet.events[i + 1];
+		}
+	}
+
+	_packet.events[_packet.eventCount++] = event;
+}
+
+void InputSource::flush(quint64 timestamp, qint64 captured)
+{
+	QMutexLocker l(&_packetMutex);
+
+	if (!_packet.eventCount)
+		return;
+
+	_packet.timestamp = timestamp;
+	_packet.captured = captured;
+	_packet.time = QDateTime::currentMSecsSinceEpoch();
+
+	// Keep the events for the next frame if the game stops taking them
+	if (_packets.push(_packet))
+	{
+		_packet.eventCount = 0;
+		_packetFull = false;
+	}
+}
+
+void InputSource::discard()
+{
+	QMutexLocker l(&_packetMutex);
+
+	_packet.eventCount = 0;
+	_packetFull = false;
+}
@@ -0,0 +1,123 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KINETRIS_INPUTSOURCE_H
+#define KINETRIS_INPUTSOURCE_H
+
+#include <QtGui/QtGui>
+
+#include "InputEvent.h"
+#include "RingBuffer.h"
+
+// Base of everything the game takes hand gestures from, e.g. the sensor, the
+// keyboard, or a synthetic hand; sources run in their own thread, report the
+// connection through signals and gestures through per-frame packets
+class InputSource : public QThread
+{
+	Q_OBJECT
+
+signals:
+
+	void evConnectBegin();
+	void evConnectError();
+	void evConnect();
+	void evDisconnect();
+
+	void evUsersMap(QImage image, QPoint offset, QSize size);
+
+public:
+
+	enum Output
+	{
+		OUTPUT_NONE = 0,
+		OUTPUT_AVATAR = 0x1, // evUsersMap
+		OUTPUT_HAND = 0x2, // takeHandPoint
+		OUTPUT_ALL = 0x3
+	};
+
+	struct HandPoint
+	{
+		quint64 timestamp; // usec, when captured
+		float position[3]; // mm
+	};
+
+	static const int PACKET_EVENTS = 16;
+
+	// Every event of one frame, in the order they occurred
+	struct Packet
+	{
+		quint64 timestamp; // usec, when captured
+		qint64 captured; // ms since epoch, when captured
+		qint64 time; // ms since epoch, when handed to the game
+		int eventCount;
+		InputEvent events[PACKET_EVENTS];
+	};
+
+	InputSource(QObject* parent);
+	virtual ~InputSource();
+
+	int getAvatarHeight() const;
+	void setAvatarHeight(int height); // px
+
+	quint32 getGestureMask() const;
+	void setGestureMask(quint32 mask); // 1 << InputEvent::Type of each gesture needed
+
+	int getOutputs() const;
+	void setOutputs(int outputs); // Output flags of what the game shows
+
+	bool takeHandPoint(HandPoint& point);
+	bool takePacket(Packet& packet);
+
+protected:
+
+	static const int HAND_POINTS = 64;
+	static const int PACKETS = 64;
+
+	int _avatarHeight; // px
+	quint32 _gestureMask;
+	int _outputs;
+	mutable QMutex _configMutex;
+
+	// Primary hand position, straight to the game thread without going
+	// through queued signals
+	RingBuffer<HandPoint, HAND_POINTS> _handPoints;
+
+	// Events of the frame being captured, and frames the game has yet to take
+	Packet _packet;
+	RingBuffer<Packet, PACKETS> _packets;
+	QMutex _packetMutex; // e.g. the keyboard dispatches from more than one thread
+	bool _packetFull; // warned about since the last flush
+
+	void init();
+
+	void publish(const HandPoint& point);
+
+	qreal getAvatarScale(int yres) const;
+
+	static bool isGesture(qint32 type);
+
+	void dispatch(InputEvent::Type type, float a = 0.0f, float b = 0.0f, float c = 0.0f);
+	virtual void dispatch(const InputEvent& event);
+
+	void flush(quint64 timestamp, qint64 captured);
+	void discard();
+};
+
+#endif // KINETRIS_INPUTSOURCE_H
@@ -0,0 +1,161 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "KeyboardSource.h"
+
+KeyboardSource::KeyboardSource(QObject* parent)
+	: InputSource(parent)
+{
+	init();
+}
+
+KeyboardSource::~KeyboardSource()
+{
+	quit();
+
+	// Wait for run method to return
+	wait();
+}
+
+void KeyboardSource::init()
+{
+	_session = false;
+
+	_clock.start();
+
+	// Keys are delivered to the parent (i.e.: the scene) in the GUI thread
+	parent()->installEventFilter(this);
+}
+
+void KeyboardSource::run()
+{
+	emit evConnectBegin();
+	emit evConnect();
+
+	dispatch(InputEvent::EVENT_USER_ENTER);
+	flush(getTimestamp(), QDateTime::currentMSecsSinceEpoch());
+
+	// Nothing to capture, keep the thread alive until we are destroyed
+	exec();
+}
+
+quint64 KeyboardSource::getTimestamp() const
+{
+	return static_cast<quint64>(_clock.elapsed()) * 1000;
+}
+
+bool KeyboardSource::eventFilter(QObject* object, QEvent* event)
+{
+	if ((event->type() == QEvent::KeyPress)
+		|| (event->type() == QEvent::KeyRelease))
+	{
+		QKeyEvent* keyEvent = static_cast<QKeyEvent*>(event);
+
+		if (!keyEvent->isAutoRepeat())
+		{
+			if (event->type() == QEvent::KeyPress)
+				onKeyPress(keyEvent->key());
+			else
+				onKeyRelease(keyEvent->key());
+
+			// One packet per key, there are no frames
+			flush(getTimestamp(), QDateTime::currentMSecsSinceEpoch());
+		}
+	}
+
+	// Let the scene see every key as well
+	return InputSource::eventFilter(object, event);
+}
+
+void KeyboardSource::onKeyPress(int key)
+{
+	if (key == Qt::Key_Left)
+	{
+		dispatch(InputEvent::EVENT_SLIDE_X, -1.0f);
+		dispatch(InputEvent::EVENT_SWIPE_X, -1.0f, 1.0f, 0.0f);
+	}
+	else if (key == Qt::Key_Right)
+	{
+		dispatch(InputEvent::EVENT_SLIDE_X, 1.0f);
+		dispatch(InputEvent::EVENT_SWIPE_X, 1.0f, 1.0f, 0.0f);
+	}
+	else if (key == Qt::Key_Down)
+	{
+		// Hand down, then swipe down to drop
+		dispatch(InputEvent::EVENT_SLIDE_Y, -1.0f);
+		dispatch(InputEvent::EVENT_SWIPE_Y, -1.0f, 1.0f, 0.0f);
+	}
+	else if (key == Qt::Key_Up)
+	{
+		// Hand up, then swipe up to hold
+		dispatch(InputEvent::EVENT_SLIDE_Y, 1.0f);
+		dispatch(InputEvent::EVENT_SWIPE_Y, 1.0f, 1.0f, 0.0f);
+	}
+	else if (key == Qt::Key_Z)
+	{
+		// Hand back, then circle to rotate
+		dispatch(InputEvent::EVENT_SLIDE_Z, 1.0f);
+		dispatch(InputEvent::EVENT_CIRCLE, -1.0f);
+	}
+	else if (key == Qt::Key_X)
+	{
+		dispatch(InputEvent::EVENT_SLIDE_Z, 1.0f);
+		dispatch(InputEvent::EVENT_CIRCLE, 1.0f);
+	}
+	else if (key == Qt::Key_Space)
+	{
+		dispatch(InputEvent::EVENT_WAVE);
+	}
+	else if (key == Qt::Key_Return)
+	{
+		_session = !_session;
+
+		if (_session)
+		{
+			dispatch(InputEvent::EVENT_SESSION_BEGIN);
+			dispatch(InputEvent::EVENT_FOCUS_GAIN);
+		}
+		else
+		{
+			dispatch(InputEvent::EVENT_FOCUS_LOSE);
+			dispatch(InputEvent::EVENT_SESSION_END);
+		}
+	}
+}
+
+void KeyboardSource::onKeyRelease(int key)
+{
+	if ((key == Qt::Key_Left)
+		|| (key == Qt::Key_Right))
+	{
+		dispatch(InputEvent::EVENT_SLIDE_X, 0.0f);
+	}
+	else if ((key == Qt::Key_Down)
+		|| (key == Qt::Key_Up))
+	{
+		dispatch(InputEvent::EVENT_SLIDE_Y, 0.0f);
+	}
+	else if ((key == Qt::Key_Z)
+		|| (key == Qt::Key_X))
+	{
+		dispatch(InputEvent::EVENT_CIRCLE, 0.0f);
+		dispatch(InputEvent::EVENT_SLIDE_Z, 0.0f);
+	}
+}
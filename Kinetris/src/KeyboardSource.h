@@ -0,0 +1,55 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KINETRIS_KEYBOARDSOURCE_H
+#define KINETRIS_KEYBOARDSOURCE_H
+
+#include <QtGui/QtGui>
+
+#include "InputSource.h"
+
+// Plays without a sensor, by translating keys into the gestures they stand for
+class KeyboardSource : public InputSource
+{
+	Q_OBJECT
+
+public:
+
+	KeyboardSource(QObject* parent);
+	virtual ~KeyboardSource();
+
+protected:
+
+	bool _session;
+	QElapsedTimer _clock;
+
+	void init();
+
+	quint64 getTimestamp() const; // usec
+
+	void run();
+
+	bool eventFilter(QObject* object, QEvent* event);
+
+	void onKeyPress(int key);
+	void onKeyRelease(int key);
+};
+
+#endif // KINETRIS_KEYBOARDSOURCE_H
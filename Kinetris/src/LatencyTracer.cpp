@@ -0,0 +1,268 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LatencyTracer.h"
+
+LatencyTracer* LatencyTracer::_instance = NULL;
+
+const char* LatencyTracer::STAGE_NAMES[] =
+{
+	"",
+	"Capture",
+	"Packet",
+	"Tick",
+	"Input",
+	"Player",
+	"Matrix",
+	"Sprite",
+	"Photon"
+};
+
+LatencyTracer::LatencyTracer(QObject* parent)
+	: QObject(parent)
+{
+	init();
+}
+
+LatencyTracer::~LatencyTracer()
+{
+	// Whatever was traced, in case it was never asked for
+	if (isEnabled())
+		save();
+
+	_instance = NULL;
+}
+
+LatencyTracer* LatencyTracer::instance(QObject* parent)
+{
+	if (!_instance)
+		_instance = new LatencyTracer(parent);
+
+	return _instance;
+}
+
+LatencyTracer* LatencyTracer::instance()
+{
+	Q_ASSERT(_instance);
+
+	return _instance;
+}
+
+void LatencyTracer::init()
+{
+	_trace = 0;
+}
+
+bool LatencyTracer::isEnabled() const
+{
+	return !_path.isEmpty();
+}
+
+QString LatencyTracer::getPath() const
+{
+	return _path;
+}
+
+void LatencyTracer::setPath(const QString& path)
+{
+	_path = path;
+}
+
+quint64 LatencyTracer::getTrace() const
+{
+	return _trace;
+}
+
+void LatencyTracer::setTrace(quint64 trace)
+{
+	_trace = trace;
+}
+
+void LatencyTracer::begin(quint64 trace, qint64 captured, qint64 packet)
+{
+	_trace = trace;
+
+	if ((!isEnabled())
+		|| (!trace))
+	{
+		return;
+	}
+
+	// Forget the oldest, rather than grow for as long as the game runs
+	if (!_traces.contains(trace))
+	{
+		if (_order.count() >= MAX_TRACES)
+			_traces.remove(_order.dequeue());
+
+		_order.enqueue(trace);
+	}
+
+	Trace& t = _traces[trace];
+	for (int i = 0; i < STAGE_; ++i)
+	{
+		t.time[i] = 0;
+	}
+
+	t.time[STAGE_CAPTURE] = captured;
+	t.time[STAGE_PACKET] = packet;
+	t.time[STAGE_TICK] = QDateTime::currentMSecsSinceEpoch();
+}
+
+void LatencyTracer::mark(Stage stage)
+{
+	if ((!isEnabled())
+		|| (!_trace))
+	{
+		return;
+	}
+
+	QHash<quint64, Trace>::iterator i = _traces.find(_trace);
+	if (i == _traces.end())
+		return;
+
+	// Only the first time, e.g. a held input moves the tetromino again later
+	if (i->time[stage])
+		return;
+
+	i->time[stage] = QDateTime::currentMSecsSinceEpoch();
+
+	if (stage == STAGE_SPRITE)
+		_presenting << _trace;
+}
+
+void LatencyTracer::present()
+{
+	if (_presenting.isEmpty())
+		return;
+
+	qint64 t = QDateTime::currentMSecsSinceEpoch();
+
+	foreach (quint64 trace, _presenting)
+	{
+		QHash<quint64, Trace>::iterator i = _traces.find(trace);
+		if ((i != _traces.end())
+			&& (!i->time[STAGE_PHOTON]))
+		{
+			i->time[STAGE_PHOTON] = t;
+		}
+	}
+
+	_presenting.clear();
+}
+
+bool LatencyTracer::save() const
+{
+	QFile file(_path);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+	{
+		qWarning() << "Unable to write latency trace" << _path;
+		return false;
+	}
+
+	QTextStream out(&file);
+
+	out << "{\n\"displayTimeUnit\": \"ms\",\n\"traceEvents\": [\n";
+
+	// Each gesture on its own track, one slice per stage it went through
+	bool first = true;
+	foreach (quint64 trace, _order)
+	{
+		const Trace& t = _traces[trace];
+
+		int last = STAGE_CAPTURE;
+		for (int i = STAGE_CAPTURE + 1; i < STAGE_; ++i)
+		{
+			if (t.time[i])
+				last = i;
+		}
+
+		QString event = QString("{\"cat\": \"latency\", \"id\": \"%1\", \"pid\": 1, \"tid\": 1, ").arg(trace);
+
+		out << ((first) ? "" : ",\n") << event << "\"ph\": \"b\", \"name\": \"Gesture\", \"ts\": " << t.time[STAGE_CAPTURE] * 1000 << "}";
+		first = false;
+
+		int previous = STAGE_CAPTURE;
+		for (int i = STAGE_CAPTURE + 1; i <= last; ++i)
+		{
+			if (!t.time[i])
+				continue;
+
+			out << ",\n" << event << "\"ph\": \"b\", \"name\": \"" << STAGE_NAMES[i] << "\", \"ts\": " << t.time[previous] * 1000 << "}";
+			out << ",\n" << event << "\"ph\": \"e\", \"name\": \"" << STAGE_NAMES[i] << "\", \"ts\": " << t.time[i] * 1000 << "}";
+			previous = i;
+		}
+
+		out << ",\n" << event << "\"ph\": \"e\", \"name\": \"Gesture\", \"ts\": " << t.time[last] * 1000 << "}";
+	}
+
+	out << "\n],\n\"otherData\": {\n";
+	writeStats(out);
+	out << "}\n}\n";
+
+	return (out.status() == QTextStream::Ok);
+}
+
+void LatencyTracer::writeStats(QTextStream& out) const
+{
+	// Time spent getting to each stage from the one before, and from capture to photon
+	QVector<QVector<qint64> > latency(STAGE_ + 1);
+
+	foreach (const Trace& t, _traces)
+	{
+		int previous = STAGE_CAPTURE;
+		for (int i = STAGE_CAPTURE + 1; i < STAGE_; ++i)
+		{
+			if (!t.time[i])
+				continue;
+
+			latency[i] << t.time[i] - t.time[previous];
+			previous = i;
+		}
+
+		if (t.time[STAGE_PHOTON])
+			latency[STAGE_] << t.time[STAGE_PHOTON] - t.time[STAGE_CAPTURE];
+	}
+
+	for (int i = STAGE_CAPTURE + 1; i <= STAGE_; ++i)
+	{
+		QVector<qint64>& l = latency[i];
+		qSort(l);
+
+		int n = l.count();
+		qint64 sum = 0;
+		foreach (qint64 d, l)
+		{
+			sum += d;
+		}
+
+		QString name = (i < STAGE_) ? STAGE_NAMES[i] : "Total";
+
+		out << "\"" << name << "\": \"n=" << n;
+		if (n)
+		{
+			out << " mean=" << sum / static_cast<qreal>(n)
+				<< " p50=" << l[n / 2]
+				<< " p90=" << l[(n * 9) / 10]
+				<< " p99=" << l[(n * 99) / 100]
+				<< " max=" << l[n - 1] << " ms";
+		}
+		out << "\"" << ((i < STAGE_) ? ",\n" : "\n");
+	}
+}
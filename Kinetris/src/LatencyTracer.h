@@ -0,0 +1,98 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KINETRIS_LATENCYTRACER_H
+#define KINETRIS_LATENCYTRACER_H
+
+#include <QtCore/QtCore>
+
+// Follows gestures from the frame they were captured in to the frame where the
+// tetromino is seen to react, and writes each stage they went through as a
+// Chrome trace (chrome://tracing, ui.perfetto.dev); only used from the game thread
+class LatencyTracer : public QObject
+{
+	Q_OBJECT
+
+public:
+
+	enum Stage
+	{
+		STAGE_NONE = 0,
+		STAGE_CAPTURE, // frame captured by the source
+		STAGE_PACKET, // gestures recognized, handed to the game
+		STAGE_TICK, // taken by the game
+		STAGE_INPUT, // InputManager state set
+		STAGE_PLAYER, // Player applied it to the matrix
+		STAGE_MATRIX, // tetromino moved
+		STAGE_SPRITE, // sprite moved
+		STAGE_PHOTON, // scene painted with the sprite moved
+		STAGE_
+	};
+
+	virtual ~LatencyTracer();
+
+	static LatencyTracer* instance(QObject* parent);
+	static LatencyTracer* instance();
+
+	bool isEnabled() const;
+
+	QString getPath() const;
+	void setPath(const QString& path); // enables tracing, if not empty
+
+	quint64 getTrace() const;
+	void setTrace(quint64 trace);
+
+	void begin(quint64 trace, qint64 captured, qint64 packet); // ms since epoch
+	void mark(Stage stage);
+	void present();
+
+	bool save() const;
+
+protected:
+
+	static const char* STAGE_NAMES[];
+
+	static const int MAX_TRACES = 4096;
+
+	struct Trace
+	{
+		qint64 time[STAGE_]; // ms since epoch, or 0 if never reached
+	};
+
+	QString _path;
+
+	quint64 _trace; // being followed, or 0 if none
+
+	QHash<quint64, Trace> _traces;
+	QQueue<quint64> _order;
+	QList<quint64> _presenting;
+
+	LatencyTracer(QObject* parent);
+
+	void init();
+
+	void writeStats(QTextStream& out) const;
+
+private:
+
+	static LatencyTracer* _instance;
+};
+
+#endif // KINETRIS_LATENCYTRACER_H
@@ -1,145 +1,503 @@
-/**
- * This file is part of Kinetris.
- * 
- * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
- * Contact: Conan Chen <http://conanchen.com/>
- * 
- * This program is free software: you can redistribute it and/or modify
- * it under the terms of the GNU General Public License as published by
- * the Free Software Foundation, either version 3 of the License, or
- * (at your option) any later version.
- * 
- * This program is distributed in the hope that it will be useful,
- * but WITHOUT ANY WARRANTY; without even the implied warranty of
- * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- * GNU General Public License for more details.
- * 
- * You should have received a copy of the GNU General Public License
- * along with this program.  If not, see <http://www.gnu.org/licenses/>.
- */
-
-#include "LoaderThread.h"
-
-LoaderThread* LoaderThread::_instance = NULL;
-
-LoaderThread::LoaderThread(QObject* parent)
-	: QThread(parent)
-{
-	init();
-}
-
-LoaderThread::~LoaderThread()
-{
-	setState(STATE_QUIT);
-
-	// Wait for run method to return
-	wait();
-}
-
-LoaderThread* LoaderThread::instance(QObject* parent)
-{
-	if (!_instance)
-		_instance = new LoaderThread(parent);
-
-	return _instance;
-}
-
-LoaderThread* LoaderThread::instance()
-{
-	Q_ASSERT(_instance);
-
-	return _instance;
-}
-
-void LoaderThread::init()
-{
-	initState();
-}
-
-void LoaderThread::initState()
-{
-	_state = STATE_NONE;
-	_s1 = STATE_NONE;
-}
-
-LoaderThread::State LoaderThread::getState() const
-{
-	QMutexLocker l(&_stateMutex);
-
-	return _state;
-}
-
-void LoaderThread::setState(State state)
-{
-	QMutexLocker l(&_stateMutex);
-
-	_s1 = state;
-}
-
-QPixmap LoaderThread::getCachedPixmap(const QString& uri) const
-{
-	QMutexLocker l(&_cacheMutex);
-
-	QPixmap pixmap;
-	if (!QPixmapCache::find(uri, pixmap))
-	{
-		pixmap.load(uri);
-		QPixmapCache::insert(uri, pixmap);
-	}
-
-	return pixmap;
-}
-
-void LoaderThread::update()
-{
-	State state = STATE_NONE;
-
-	{
-		QMutexLocker l(&_stateMutex);
-
-		if (_s1 != _state)
-		{
-			onStateLeave(_state);
-			_state = _s1;
-			onStateEnter(_state);
-		}
-
-		state = _state;
-	}
-
-	if (!state)
-	{
-		//
-	}
-	else if (state == STATE_LOAD)
-	{
-		//
-	}
-	else if (state == STATE_QUIT)
-	{
-	}
-}
-
-void LoaderThread::run()
-{
-	initState();
-
-	while (getState() != STATE_QUIT)
-	{
-		msleep(0);
-
-		update();
-	}
-}
-
-void LoaderThread::onStateEnter(State state)
-{
-	// Prevent "unreferenced formal parameter" warning
-	state;
-}
-
-void LoaderThread::onStateLeave(State state)
-{
-	// Prevent "unreferenced formal parameter" warning
-	state;
-}
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LoaderThread.h"
+
+LoaderThread* LoaderThread::_instance = NULL;
+
+const int LoaderThread::IDLE_TIMEOUT = 100; // ms
+
+const qint64 LoaderThread::IMAGE_BUDGET = 32 * 1024 * 1024; // bytes
+const qint64 LoaderThread::PIXMAP_BUDGET = 32 * 1024 * 1024; // bytes
+
+LoaderThread::Task::Task(LoaderThread* loader, const QString& uri)
+	: QRunnable()
+{
+	_loader = loader;
+	_uri = uri;
+}
+
+void LoaderThread::Task::run()
+{
+	_loader->finish(_uri, _loader->decode(_uri));
+}
+
+LoaderThread::LoaderThread(QObject* parent)
+	: QThread(parent)
+{
+	init();
+}
+
+LoaderThread::~LoaderThread()
+{
+	setState(STATE_QUIT);
+
+	// Wait for run method to return
+	wait();
+
+	// Wait for images still decoding
+	_pool->waitForDone();
+
+	_instance = NULL;
+}
+
+LoaderThread* LoaderThread::instance(QObject* parent)
+{
+	if (!_instance)
+		_instance = new LoaderThread(parent);
+
+	return _instance;
+}
+
+LoaderThread* LoaderThread::instance()
+{
+	Q_ASSERT(_instance);
+
+	return _instance;
+}
+
+void LoaderThread::init()
+{
+	initBundle();
+	initPool();
+	initCache();
+	initState();
+
+	setState(STATE_LOAD);
+}
+
+void LoaderThread::initBundle()
+{
+	// Pre-decoded images from tools/AssetPacker, when the bundle sits beside the executable
+	_bundle.open(AssetBundle::getDefaultPath());
+}
+
+void LoaderThread::initPool()
+{
+	_pool = new QThreadPool(this);
+	_pool->setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+}
+
+void LoaderThread::initCache()
+{
+	_imageBytes = 0;
+	_imageBudget = IMAGE_BUDGET;
+	_imageTick = 0;
+
+	_pixmapBudget = PIXMAP_BUDGET;
+	_pixmapTick = 0;
+}
+
+void LoaderThread::initState()
+{
+	_state = STATE_NONE;
+	_s1 = STATE_NONE;
+}
+
+LoaderThread::State LoaderThread::getState() const
+{
+	QMutexLocker l(&_stateMutex);
+
+	return _state;
+}
+
+void LoaderThread::setState(State state)
+{
+	{
+		QMutexLocker l(&_stateMutex);
+
+		_s1 = state;
+	}
+
+	QMutexLocker l(&_cacheMutex);
+
+	_queueCondition.wakeAll();
+}
+
+qint64 LoaderThread::getImageBudget() const
+{
+	QMutexLocker l(&_cacheMutex);
+
+	return _imageBudget;
+}
+
+void LoaderThread::setImageBudget(qint64 budget)
+{
+	QMutexLocker l(&_cacheMutex);
+
+	_imageBudget = budget;
+	trimImages(QString());
+}
+
+qint64 LoaderThread::getPixmapBudget() const
+{
+	return _pixmapBudget;
+}
+
+void LoaderThread::setPixmapBudget(qint64 budget)
+{
+	_pixmapBudget = budget;
+	trimPixmaps(-1);
+}
+
+void LoaderThread::prefetch(const QStringList& uris)
+{
+	QMutexLocker l(&_cacheMutex);
+
+	int handle;
+	foreach (const QString& uri, uris)
+	{
+		handle = _handles.value(uri, -1);
+		if (((handle >= 0) && (!_pixmaps[handle].isNull()))
+			|| _images.contains(uri)
+			|| _busy.contains(uri)
+			|| _queue.contains(uri))
+			continue;
+
+		_queue.enqueue(uri);
+	}
+
+	_queueCondition.wakeAll();
+}
+
+void LoaderThread::load(const QString& uri, QObject* receiver, const char* member)
+{
+	Callback callback;
+	callback.receiver = receiver;
+	callback.member = member;
+
+	int handle = _handles.value(uri, -1);
+	if ((handle >= 0) && (!_pixmaps[handle].isNull()))
+	{
+		QMetaObject::invokeMethod(receiver, member, Qt::QueuedConnection,
+			Q_ARG(QString, uri), Q_ARG(QPixmap, getPixmap(handle)));
+		return;
+	}
+
+	bool decoded = false;
+
+	{
+		QMutexLocker l(&_cacheMutex);
+
+		_callbacks.insert(uri, callback);
+
+		// The pixmap was trimmed but the image is still here, so prefetch will skip it
+		decoded = (_images.contains(uri) && !_busy.contains(uri));
+	}
+
+	if (decoded)
+	{
+		QMetaObject::invokeMethod(this, "onDecoded", Qt::QueuedConnection, Q_ARG(QString, uri));
+		return;
+	}
+
+	prefetch(QStringList(uri));
+}
+
+QPixmap LoaderThread::getCachedPixmap(const QString& uri)
+{
+	return getPixmap(getHandle(uri));
+}
+
+int LoaderThread::getHandle(const QString& uri)
+{
+	int handle = _handles.value(uri, -1);
+	if (handle < 0)
+	{
+		handle = _uris.count();
+		_handles.insert(uri, handle);
+		_uris << uri;
+		_pixmaps << QPixmap();
+		_pixmapUsed << 0;
+
+		prefetch(QStringList(uri));
+	}
+
+	return handle;
+}
+
+QPixmap LoaderThread::getPixmap(int handle)
+{
+	_pixmapUsed[handle] = ++_pixmapTick;
+
+	if (_pixmaps[handle].isNull())
+	{
+		QPixmap pixmap = QPixmap::fromImage(getImage(_uris[handle]));
+
+		_pixmaps[handle] = pixmap;
+		trimPixmaps(handle);
+	}
+
+	return _pixmaps[handle];
+}
+
+void LoaderThread::load(int handle, QObject* receiver, const char* member)
+{
+	load(_uris[handle], receiver, member);
+}
+
+void LoaderThread::update()
+{
+	State state = STATE_NONE;
+
+	{
+		QMutexLocker l(&_stateMutex);
+
+		if (_s1 != _state)
+		{
+			onStateLeave(_state);
+			_state = _s1;
+			onStateEnter(_state);
+		}
+
+		state = _state;
+	}
+
+	if (!state)
+	{
+		//
+	}
+	else if (state == STATE_LOAD)
+	{
+		dispatch();
+	}
+	else if (state == STATE_QUIT)
+	{
+	}
+}
+
+void LoaderThread::dispatch()
+{
+	QMutexLocker l(&_cacheMutex);
+
+	// Hand out one image per worker, keeping the rest here where getCachedPixmap can take them back
+	if (_queue.isEmpty() || (_busy.count() >= _pool->maxThreadCount()))
+	{
+		_queueCondition.wait(&_cacheMutex, IDLE_TIMEOUT);
+		return;
+	}
+
+	QString uri = _queue.dequeue();
+	_busy.insert(uri);
+
+	_pool->start(new Task(this, uri));
+}
+
+QImage LoaderThread::decode(const QString& uri) const
+{
+	QImage image;
+	if (_bundle.contains(uri))
+	{
+		image = _bundle.getImage(uri);
+	}
+	else
+	{
+		QImageReader reader(uri);
+		image = reader.read();
+		if (image.isNull())
+		{
+			qWarning("LoaderThread: cannot decode %s: %s", qPrintable(uri), qPrintable(reader.errorString()));
+			return image;
+		}
+	}
+
+	// Leave the GUI thread nothing to convert
+	if (image.hasAlphaChannel())
+	{
+		if (image.format() != QImage::Format_ARGB32_Premultiplied)
+			image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+	}
+	else
+	{
+		if (image.format() != QImage::Format_RGB32)
+			image = image.convertToFormat(QImage::Format_RGB32);
+	}
+
+	return image;
+}
+
+void LoaderThread::finish(const QString& uri, const QImage& image)
+{
+	{
+		QMutexLocker l(&_cacheMutex);
+
+		_busy.remove(uri);
+		insertImage(uri, image);
+
+		_imageCondition.wakeAll();
+		_queueCondition.wakeAll();
+	}
+
+	QMetaObject::invokeMethod(this, "onDecoded", Qt::QueuedConnection, Q_ARG(QString, uri));
+}
+
+QImage LoaderThread::getImage(const QString& uri)
+{
+	{
+		QMutexLocker l(&_cacheMutex);
+
+		// Not picked up yet, so decode it here rather than wait behind the queue
+		_queue.removeAll(uri);
+
+		// Already being decoded, so wait for it
+		while (_busy.contains(uri))
+		{
+			_imageCondition.wait(&_cacheMutex);
+		}
+
+		QHash<QString, CachedImage>::iterator i = _images.find(uri);
+		if (i != _images.end())
+		{
+			i->used = ++_imageTick;
+			return i->image;
+		}
+	}
+
+	QImage image = decode(uri);
+	bool waiting = false;
+
+	{
+		QMutexLocker l(&_cacheMutex);
+
+		insertImage(uri, image);
+
+		// Taken off the queue above, so no worker will report it
+		waiting = _callbacks.contains(uri);
+	}
+
+	if (waiting)
+		QMetaObject::invokeMethod(this, "onDecoded", Qt::QueuedConnection, Q_ARG(QString, uri));
+
+	return image;
+}
+
+void LoaderThread::insertImage(const QString& uri, const QImage& image)
+{
+	// Called with _cacheMutex held
+	QHash<QString, CachedImage>::iterator i = _images.find(uri);
+	if (i != _images.end())
+		_imageBytes -= i->bytes;
+
+	// Images straight from the bundle cost no heap, so they never push others out
+	CachedImage cached = {image, (_bundle.isMapped(image)) ? 0 : image.byteCount(), ++_imageTick};
+	_images.insert(uri, cached);
+	_imageBytes += cached.bytes;
+
+	trimImages(uri);
+}
+
+void LoaderThread::trimImages(const QString& keep)
+{
+	// Called with _cacheMutex held
+	while (_imageBytes > _imageBudget)
+	{
+		QHash<QString, CachedImage>::iterator oldest = _images.end();
+		for (QHash<QString, CachedImage>::iterator i = _images.begin(); i != _images.end(); ++i)
+		{
+			if ((i.key() == keep) || (!i->bytes))
+				continue;
+
+			if ((oldest == _images.end()) || (i->used < oldest->used))
+				oldest = i;
+		}
+
+		if (oldest == _images.end())
+			break;
+
+		_imageBytes -= oldest->bytes;
+		_images.erase(oldest);
+	}
+}
+
+void LoaderThread::trimPixmaps(int keep)
+{
+	// Only pixmaps nothing else holds count, and only they can go: dropping one an
+	// item still shows frees nothing, and the next getPixmap would upload it twice
+	qint64 bytes = 0;
+	for (int i = 0, il = _pixmaps.count(); i < il; ++i)
+	{
+		if ((!_pixmaps[i].isNull()) && (_pixmaps[i].isDetached()))
+			bytes += (static_cast<qint64>(_pixmaps[i].width()) * _pixmaps[i].height() * _pixmaps[i].depth()) / 8;
+	}
+
+	while (bytes > _pixmapBudget)
+	{
+		int oldest = -1;
+		for (int i = 0, il = _pixmaps.count(); i < il; ++i)
+		{
+			if ((i == keep) || (_pixmaps[i].isNull()) || (!_pixmaps[i].isDetached()))
+				continue;
+
+			if ((oldest < 0) || (_pixmapUsed[i] < _pixmapUsed[oldest]))
+				oldest = i;
+		}
+
+		if (oldest < 0)
+			break;
+
+		bytes -= (static_cast<qint64>(_pixmaps[oldest].width()) * _pixmaps[oldest].height() * _pixmaps[oldest].depth()) / 8;
+		_pixmaps[oldest] = QPixmap();
+	}
+}
+
+void LoaderThread::run()
+{
+	while (getState() != STATE_QUIT)
+	{
+		update();
+	}
+}
+
+void LoaderThread::onStateEnter(State state)
+{
+	// Prevent "unreferenced formal parameter" warning
+	state;
+}
+
+void LoaderThread::onStateLeave(State state)
+{
+	// Prevent "unreferenced formal parameter" warning
+	state;
+}
+
+void LoaderThread::onDecoded(QString uri)
+{
+	QPixmap pixmap = getCachedPixmap(uri);
+
+	QList<Callback> callbacks;
+
+	{
+		QMutexLocker l(&_cacheMutex);
+
+		callbacks = _callbacks.values(uri);
+		_callbacks.remove(uri);
+	}
+
+	foreach (const Callback& callback, callbacks)
+	{
+		if (!callback.receiver)
+			continue;
+
+		QMetaObject::invokeMethod(callback.receiver, callback.member.constData(),
+			Q_ARG(QString, uri), Q_ARG(QPixmap, pixmap));
+	}
+
+	emit evLoaded(uri);
+}
@@ -1,77 +1,172 @@
-/**
- * This file is part of Kinetris.
- * 
- * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
- * Contact: Conan Chen <http://conanchen.com/>
- * 
- * This program is free software: you can redistribute it and/or modify
- * it under the terms of the GNU General Public License as published by
- * the Free Software Foundation, either version 3 of the License, or
- * (at your option) any later version.
- * 
- * This program is distributed in the hope that it will be useful,
- * but WITHOUT ANY WARRANTY; without even the implied warranty of
- * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- * GNU General Public License for more details.
- * 
- * You should have received a copy of the GNU General Public License
- * along with this program.  If not, see <http://www.gnu.org/licenses/>.
- */
-
-#ifndef KINETRIS_LOADERTHREAD_H
-#define KINETRIS_LOADERTHREAD_H
-
-#include <QtGui/QtGui>
-
-class LoaderThread : public QThread
-{
-signals:
-
-	//
-
-public:
-
-	enum State
-	{
-		STATE_NONE = 0,
-		STATE_LOAD,
-		STATE_QUIT
-	};
-
-	virtual ~LoaderThread();
-
-	static LoaderThread* instance(QObject* parent);
-	static LoaderThread* instance();
-
-	State getState() const;
-
-	QPixmap getCachedPixmap(const QString& uri) const;
-
-protected:
-
-	State _state;
-	State _s1;
-	mutable QMutex _stateMutex;
-
-	mutable QMutex _cacheMutex;
-
-	LoaderThread(QObject* parent);
-
-	void init();
-	void initState();
-	
-	void setState(State state);
-
-	void run();
-
-	void update();
-
-	void onStateEnter(State state);
-	void onStateLeave(State state);
-
-private:
-
-	static LoaderThread* _instance;
-};
-
-#endif // KINETRIS_LOADERTHREAD_H
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KINETRIS_LOADERTHREAD_H
+#define KINETRIS_LOADERTHREAD_H
+
+#include <QtGui/QtGui>
+
+#include "AssetBundle.h"
+
+// Decodes images on a pool of worker threads, in the order they are asked
+// for; the GUI thread turns them into pixmaps as they arrive, and hands them
+// to whoever asked through a queued call; images the game uses throughout
+// are resolved to integer handles up front. Decoded images and pixmaps are
+// cached in two tiers, each trimmed to its budget least recently used first
+class LoaderThread : public QThread
+{
+	Q_OBJECT
+
+signals:
+
+	void evLoaded(QString uri);
+
+public:
+
+	enum State
+	{
+		STATE_NONE = 0,
+		STATE_LOAD,
+		STATE_QUIT
+	};
+
+	virtual ~LoaderThread();
+
+	static LoaderThread* instance(QObject* parent);
+	static LoaderThread* instance();
+
+	State getState() const;
+
+	qint64 getImageBudget() const; // bytes
+	void setImageBudget(qint64 budget);
+	qint64 getPixmapBudget() const; // bytes
+	void setPixmapBudget(qint64 budget);
+
+	// GUI thread only, like everything that touches pixmaps
+	void prefetch(const QStringList& uris);
+	void load(const QString& uri, QObject* receiver, const char* member); // member(QString uri, QPixmap pixmap)
+
+	QPixmap getCachedPixmap(const QString& uri);
+
+	// Resolve once, then index; both on the GUI thread only, so no locks
+	int getHandle(const QString& uri);
+	QPixmap getPixmap(int handle);
+	void load(int handle, QObject* receiver, const char* member);
+
+protected:
+
+	class Task : public QRunnable
+	{
+	public:
+
+		Task(LoaderThread* loader, const QString& uri);
+
+		void run();
+
+	protected:
+
+		LoaderThread* _loader;
+		QString _uri;
+	};
+
+	struct Callback
+	{
+		QPointer<QObject> receiver;
+		QByteArray member;
+	};
+
+	struct CachedImage
+	{
+		QImage image;
+		qint64 bytes; // on the heap, 0 while it reads from the bundle mapping
+		quint64 used; // _imageTick when last asked for
+	};
+
+	static const int IDLE_TIMEOUT; // ms
+
+	static const qint64 IMAGE_BUDGET; // bytes
+	static const qint64 PIXMAP_BUDGET; // bytes
+
+	State _state;
+	State _s1;
+	mutable QMutex _stateMutex;
+
+	mutable QMutex _cacheMutex;
+	QWaitCondition _queueCondition;
+	QWaitCondition _imageCondition;
+
+	QThreadPool* _pool;
+
+	QQueue<QString> _queue; // waiting for a worker
+	QSet<QString> _busy; // being decoded
+	QMultiHash<QString, Callback> _callbacks;
+
+	// Decoded, shared with the workers under _cacheMutex
+	QHash<QString, CachedImage> _images;
+	qint64 _imageBytes;
+	qint64 _imageBudget; // bytes
+	quint64 _imageTick;
+
+	// Uploaded, GUI thread only
+	QHash<QString, int> _handles;
+	QVector<QString> _uris; // by handle
+	QVector<QPixmap> _pixmaps; // by handle
+	QVector<quint64> _pixmapUsed; // by handle, _pixmapTick when last asked for
+	qint64 _pixmapBudget; // bytes
+	quint64 _pixmapTick;
+
+	AssetBundle _bundle;
+
+	LoaderThread(QObject* parent);
+
+	void init();
+	void initBundle();
+	void initPool();
+	void initCache();
+	void initState();
+	
+	void setState(State state);
+
+	void run();
+
+	void update();
+	void dispatch();
+
+	QImage decode(const QString& uri) const;
+	void finish(const QString& uri, const QImage& image);
+
+	QImage getImage(const QString& uri);
+	void insertImage(const QString& uri, const QImage& image);
+	void trimImages(const QString& keep);
+	void trimPixmaps(int keep);
+
+	void onStateEnter(State state);
+	void onStateLeave(State state);
+
+protected slots:
+
+	void onDecoded(QString uri);
+
+private:
+
+	static LoaderThread* _instance;
+};
+
+#endif // KINETRIS_LOADERTHREAD_H
@@ -0,0 +1,98 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KINETRIS_RINGBUFFER_H
+#define KINETRIS_RINGBUFFER_H
+
+#include <QtCore/QtCore>
+
+// Lock-free queue between exactly one producer thread and one consumer thread;
+// holds up to SIZE - 1 items, and push fails rather than block when full
+template <typename T, int SIZE>
+class RingBuffer
+{
+public:
+
+	RingBuffer();
+	virtual ~RingBuffer();
+
+	bool isEmpty() const; // consumer
+
+	bool push(const T& item); // producer
+	bool pop(T& item); // consumer
+
+protected:
+
+	T _items[SIZE];
+
+	QAtomicInt _head; // written by producer
+	QAtomicInt _tail; // written by consumer
+};
+
+template <typename T, int SIZE>
+RingBuffer<T, SIZE>::RingBuffer()
+	: _head(0), _tail(0)
+{
+}
+
+template <typename T, int SIZE>
+RingBuffer<T, SIZE>::~RingBuffer()
+{
+}
+
+template <typename T, int SIZE>
+bool RingBuffer<T, SIZE>::isEmpty() const
+{
+	return (const_cast<QAtomicInt&>(_tail).fetchAndAddRelaxed(0) == const_cast<QAtomicInt&>(_head).fetchAndAddAcquire(0));
+}
+
+template <typename T, int SIZE>
+bool RingBuffer<T, SIZE>::push(const T& item)
+{
+	int head = _head.fetchAndAddRelaxed(0);
+	int next = (head + 1) % SIZE;
+
+	// Full, consumer has fallen behind
+	if (next == _tail.fetchAndAddAcquire(0))
+		return false;
+
+	_items[head] = item;
+
+	// Publish item before the new head
+	_head.fetchAndStoreRelease(next);
+	return true;
+}
+
+template <typename T, int SIZE>
+bool RingBuffer<T, SIZE>::pop(T& item)
+{
+	int tail = _tail.fetchAndAddRelaxed(0);
+
+	if (tail == _head.fetchAndAddAcquire(0))
+		return false;
+
+	item = _items[tail];
+
+	// Release slot only after item was copied out
+	_tail.fetchAndStoreRelease((tail + 1) % SIZE);
+	return true;
+}
+
+#endif // KINETRIS_RINGBUFFER_H
@@ -0,0 +1,258 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SensorRecording.h"
+
+const char SensorRecording::MAGIC[] = "KNSR";
+const quint32 SensorRecording::VERSION = 1;
+
+const int SensorRecording::BYTES_PER_PIXEL[MAP_] = {
+	0, // None
+	2, // Depth; XnDepthPixel
+	3, // Image; XnRGB24Pixel
+	2 // Label; XnLabel
+};
+
+SensorRecording::SensorRecording()
+{
+	Q_ASSERT(sizeof(InputEvent) % 8 == 0);
+	Q_ASSERT(sizeof(FrameHeader) % 8 == 0);
+	Q_ASSERT(sizeof(MapHeader) % 8 == 0);
+
+	_data = NULL;
+}
+
+SensorRecording::~SensorRecording()
+{
+	close();
+}
+
+bool SensorRecording::open(const QString& path, QIODevice::OpenMode mode)
+{
+	close();
+
+	_file.setFileName(path);
+
+	if (mode & QIODevice::WriteOnly)
+	{
+		// Keep appending to an existing recording, e.g. after reconnecting
+		if (!_file.open(QIODevice::WriteOnly | QIODevice::Append))
+			return false;
+
+		if (!_file.size())
+		{
+			FileHeader header;
+			memset(&header, 0, sizeof(header));
+			memcpy(header.magic, MAGIC, sizeof(header.magic));
+			header.version = VERSION;
+
+			_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		}
+
+		return true;
+	}
+	else
+	{
+		if (!_file.open(QIODevice::ReadOnly))
+			return false;
+
+		_data = _file.map(0, _file.size());
+
+		if ((!_data)
+			|| (!initFrames()))
+		{
+			close();
+			return false;
+		}
+
+		return true;
+	}
+}
+
+void SensorRecording::close()
+{
+	if (_data)
+		_file.unmap(const_cast<uchar*>(_data));
+
+	_data = NULL;
+	_frames.clear();
+
+	_file.close();
+}
+
+bool SensorRecording::isReadable() const
+{
+	return (_data != NULL);
+}
+
+bool SensorRecording::isWritable() const
+{
+	return ((_file.isOpen())
+		&& (_file.openMode() & QIODevice::WriteOnly));
+}
+
+int SensorRecording::getFrameCount() const
+{
+	return _frames.count();
+}
+
+bool SensorRecording::readFrame(int index, Frame& frame) const
+{
+	if ((index < 0) || (index >= _frames.count()))
+		return false;
+
+	// initFrames made sure the frame header, and the whole frame, lie within the file
+	const uchar* p = _data + _frames[index];
+	const FrameHeader* header = reinterpret_cast<const FrameHeader*>(p);
+	const uchar* end = p + header->size;
+
+	p += sizeof(FrameHeader);
+
+	for (int i = 0; i < MAP_; ++i)
+	{
+		frame.xres[i] = 0;
+		frame.yres[i] = 0;
+		frame.data[i] = NULL;
+	}
+
+	// Check every record against the end of the frame before stepping over it
+	qint64 size = pad(static_cast<qint64>(sizeof(InputEvent)) * header->eventCount);
+	if (size > end - p)
+		return false;
+
+	frame.timestamp = header->timestamp;
+	frame.eventCount = header->eventCount;
+	frame.events = reinterpret_cast<const InputEvent*>(p);
+
+	p += size;
+
+	for (int i = 0; i < header->mapCount; ++i)
+	{
+		if (static_cast<qint64>(sizeof(MapHeader)) > end - p)
+			return false;
+
+		const MapHeader* map = reinterpret_cast<const MapHeader*>(p);
+
+		p += sizeof(MapHeader);
+
+		size = pad(static_cast<qint64>(map->xres) * map->yres * map->bytesPerPixel);
+		if (size > end - p)
+			return false;
+
+		if ((map->type > MAP_NONE) && (map->type < MAP_)
+			&& (map->bytesPerPixel == BYTES_PER_PIXEL[map->type]))
+		{
+			frame.xres[map->type] = map->xres;
+			frame.yres[map->type] = map->yres;
+			frame.data[map->type] = p;
+		}
+
+		p += size;
+	}
+
+	return true;
+}
+
+bool SensorRecording::writeFrame(const Frame& frame)
+{
+	static const char padding[8] = {0};
+
+	if (!isWritable())
+		return false;
+
+	FrameHeader header;
+	header.timestamp = frame.timestamp;
+	header.size = sizeof(FrameHeader) + pad(sizeof(InputEvent) * frame.eventCount);
+	header.eventCount = frame.eventCount;
+	header.mapCount = 0;
+
+	for (int i = MAP_NONE + 1; i < MAP_; ++i)
+	{
+		if (!frame.data[i])
+			continue;
+
+		header.size += sizeof(MapHeader) + pad(frame.xres[i] * frame.yres[i] * BYTES_PER_PIXEL[i]);
+		++header.mapCount;
+	}
+
+	qint64 size = sizeof(InputEvent) * frame.eventCount;
+
+	_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	_file.write(reinterpret_cast<const char*>(frame.events), size);
+	_file.write(padding, pad(size) - size);
+
+	for (int i = MAP_NONE + 1; i < MAP_; ++i)
+	{
+		if (!frame.data[i])
+			continue;
+
+		MapHeader map;
+		map.type = i;
+		map.bytesPerPixel = BYTES_PER_PIXEL[i];
+		map.xres = frame.xres[i];
+		map.yres = frame.yres[i];
+
+		size = frame.xres[i] * frame.yres[i] * BYTES_PER_PIXEL[i];
+
+		_file.write(reinterpret_cast<const char*>(&map), sizeof(map));
+		_file.write(reinterpret_cast<const char*>(frame.data[i]), size);
+		_file.write(padding, pad(size) - size);
+	}
+
+	return (_file.error() == QFile::NoError);
+}
+
+qint64 SensorRecording::pad(qint64 size)
+{
+	return (size + 7) & ~7;
+}
+
+bool SensorRecording::initFrames()
+{
+	qint64 total = _file.size();
+
+	if (total < static_cast<qint64>(sizeof(FileHeader)))
+		return false;
+
+	const FileHeader* file = reinterpret_cast<const FileHeader*>(_data);
+	if ((memcmp(file->magic, MAGIC, sizeof(file->magic)))
+		|| (file->version != VERSION))
+	{
+		return false;
+	}
+
+	// Index frames, dropping a truncated frame at the end of the file
+	qint64 offset = sizeof(FileHeader);
+	while (offset + static_cast<qint64>(sizeof(FrameHeader)) <= total)
+	{
+		const FrameHeader* header = reinterpret_cast<const FrameHeader*>(_data + offset);
+		if ((header->size < sizeof(FrameHeader))
+			|| (header->size % 8)
+			|| (offset + header->size > total))
+		{
+			break;
+		}
+
+		_frames << offset;
+		offset += header->size;
+	}
+
+	return true;
+}
@@ -0,0 +1,110 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KINETRIS_SENSORRECORDING_H
+#define KINETRIS_SENSORRECORDING_H
+
+#include <QtCore/QtCore>
+
+#include "InputEvent.h"
+
+class SensorRecording
+{
+public:
+
+	enum Map
+	{
+		MAP_NONE = 0,
+		MAP_DEPTH,
+		MAP_IMAGE,
+		MAP_LABEL,
+		MAP_
+	};
+
+	struct Frame
+	{
+		quint64 timestamp; // usec
+
+		int eventCount;
+		const InputEvent* events;
+
+		int xres[MAP_];
+		int yres[MAP_];
+		const void* data[MAP_];
+	};
+
+	SensorRecording();
+	virtual ~SensorRecording();
+
+	bool open(const QString& path, QIODevice::OpenMode mode);
+	void close();
+
+	bool isReadable() const;
+	bool isWritable() const;
+
+	int getFrameCount() const;
+
+	bool readFrame(int index, Frame& frame) const;
+	bool writeFrame(const Frame& frame);
+
+protected:
+
+	static const char MAGIC[];
+	static const quint32 VERSION;
+
+	static const int BYTES_PER_PIXEL[MAP_];
+
+	// All records are padded to 8 bytes, so that every field in a mapped
+	// file is naturally aligned
+
+	struct FileHeader
+	{
+		char magic[4];
+		quint32 version;
+		quint32 reserved[2];
+	};
+
+	struct FrameHeader
+	{
+		quint64 timestamp; // usec
+		quint32 size; // bytes, including header
+		quint16 eventCount;
+		quint16 mapCount;
+	};
+
+	struct MapHeader
+	{
+		quint16 type;
+		quint16 bytesPerPixel;
+		quint16 xres;
+		quint16 yres;
+	};
+
+	QFile _file;
+
+	const uchar* _data;
+	QVector<qint64> _frames;
+
+	static qint64 pad(qint64 size);
+
+	bool initFrames();
+};
+
+#endif // KINETRIS_SENSORRECORDING_H
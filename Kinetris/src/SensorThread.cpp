@@ -1,578 +1,1301 @@
-/**
- * This file is part of Kinetris.
- * 
- * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
- * Contact: Conan Chen <http://conanchen.com/>
- * 
- * This program is free software: you can redistribute it and/or modify
- * it under the terms of the GNU General Public License as published by
- * the Free Software Foundation, either version 3 of the License, or
- * (at your option) any later version.
- * 
- * This program is distributed in the hope that it will be useful,
- * but WITHOUT ANY WARRANTY; without even the implied warranty of
- * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- * GNU General Public License for more details.
- * 
- * You should have received a copy of the GNU General Public License
- * along with this program.  If not, see <http://www.gnu.org/licenses/>.
- */
-
-#include "SensorThread.h"
-
-const char* SensorThread::CONFIG = "./OpenNI.xml";
-
-const XnDepthPixel SensorThread::DEPTH_MIN = 1000; // mm
-const XnDepthPixel SensorThread::DEPTH_MAX = 3000; // mm
-
-SensorThread::SensorThread(QObject* parent)
-	: QThread(parent)
-{
-	init();
-}
-
-SensorThread::~SensorThread()
-{
-	setState(STATE_QUIT);
-
-	// Wait for run method to return
-	wait();
-}
-
-void SensorThread::init()
-{
-	_context = NULL;
-
-	_sessionManager = NULL;
-	_pointDenoiser = NULL;
-	_steadyDetector = NULL;
-	_circleDetector = NULL;
-	_slideXDetector = NULL;
-	_slideYDetector = NULL;
-	_slideZDetector = NULL;
-	_swipeDetector = NULL;
-	_pushDetector = NULL;
-	_waveDetector = NULL;
-
-//	_depthHistogram.fill(0, 10000); // 10m
-
-	_c0 = 0;
-
-	initState();
-}
-
-void SensorThread::initState()
-{
-	_state = STATE_NONE;
-	_s1 = STATE_NONE;
-}
-
-void SensorThread::initContext()
-{
-	_context->FindExistingNode(XN_NODE_TYPE_DEPTH, _depthGenerator);
-
-	if (_context->FindExistingNode(XN_NODE_TYPE_IMAGE, _imageGenerator) == XN_STATUS_OK)
-	{
-		xn::ImageMetaData imageMetaData;
-		_imageGenerator.GetMetaData(imageMetaData);
-		_usersMap = QImage(imageMetaData.XRes(), imageMetaData.YRes(), QImage::Format_ARGB32_Premultiplied);
-	}
-	else
-	{
-		_imageGenerator = NULL;
-
-		xn::DepthMetaData depthMetaData;
-		_depthGenerator.GetMetaData(depthMetaData);
-		_usersMap = QImage(depthMetaData.XRes(), depthMetaData.YRes(), QImage::Format_ARGB32_Premultiplied);
-	}
-
-	_context->FindExistingNode(XN_NODE_TYPE_USER, _userGenerator);
-
-	XnCallbackHandle handle;
-	_userGenerator.RegisterUserCallbacks(&SensorThread::onNewUser, &SensorThread::onLostUser, this, handle);
-
-	_context->StartGeneratingAll();
-}
-
-void SensorThread::initSession()
-{
-	_sessionManager = new XnVSessionManager();
-	_sessionManager->Initialize(_context, "Wave", "");
-	_sessionManager->SetQuickRefocusTimeout(1500); // default=15000; ms
-	_sessionManager->RegisterSession(this, &SensorThread::onSessionStart, &SensorThread::onSessionEnd);
-
-	_pointDenoiser = new XnVPointDenoiser();
-	_pointDenoiser->SetDistanceThreshold(10.0f); // default=10.0; mm
-	_pointDenoiser->SetCloseRatio(0.0f); // default=0.0
-	_pointDenoiser->SetFarRatio(1.0f); // default=1.0
-	_pointDenoiser->RegisterPrimaryPointCreate(this, &SensorThread::onPrimaryPointCreate);
-	_pointDenoiser->RegisterPrimaryPointDestroy(this, &SensorThread::onPrimaryPointDestroy);
-	_pointDenoiser->RegisterPrimaryPointReplace(this, &SensorThread::onPrimaryPointReplace);
-	_sessionManager->AddListener(_pointDenoiser);
-
-	_steadyDetector = new XnVSteadyDetector();
-	_steadyDetector->SetDetectionDuration(200); // default=200; ms
-	_steadyDetector->SetMaximumStdDevForSteady(0.01f); // default=0.01; m/sec
-	_steadyDetector->SetMinimumStdDevForNotSteady(0.02f); // default=0.02; m/sec
-	_steadyDetector->RegisterSteady(this, &SensorThread::onSteady);
-	_steadyDetector->RegisterNotSteady(this, &SensorThread::onNotSteady);
-	_pointDenoiser->AddListener(_steadyDetector);
-
-	_circleDetector = new XnVCircleDetector();
-	_circleDetector->SetMinRadius(40.0f); // default=40.0; mm
-	_circleDetector->SetMaxRadius(1200.0f); // default=1200.0; mm
-	_circleDetector->SetExistingWeight(0.8f); // default=0.8
-	_circleDetector->SetCloseToExistingRadius(50.0f); // default=50.0; mm
-	_circleDetector->SetCloseEnough(1000.0f); // default=1000; mm^2
-	_circleDetector->SetMinimumPoints(20); // default=20
-	_circleDetector->SetMaxErrors(5); // default=5
-	_circleDetector->RegisterCircle(this, &SensorThread::onCircle);
-	_pointDenoiser->AddListener(_circleDetector);
-
-	_slideXDetector = new XnVSelectableSlider1D(1, 0.0f, AXIS_X, false);
-	_slideXDetector->SetSliderSize(150.0f); // default=250.0; mm
-	_slideXDetector->SetBorderWidth(0.0f); // default=0.0
-	_slideXDetector->SetHysteresisRatio(0.5f); // default=0.5
-	_slideXDetector->SetValueChangeOnOffAxis(false); // default=false
-	_slideXDetector->RegisterValueChange(this, &SensorThread::onSlideX);
-	_pointDenoiser->AddListener(_slideXDetector);
-
-	_slideYDetector = new XnVSelectableSlider1D(1, 0.0f, AXIS_Y, false);
-	_slideYDetector->SetSliderSize(150.0f); // default=250.0; mm
-	_slideYDetector->SetBorderWidth(0.0f); // default=0.0
-	_slideYDetector->SetHysteresisRatio(0.5f); // default=0.5
-	_slideYDetector->SetValueChangeOnOffAxis(false); // default=false
-	_slideYDetector->RegisterValueChange(this, &SensorThread::onSlideY);
-	_pointDenoiser->AddListener(_slideYDetector);
-
-	_slideZDetector = new XnVSelectableSlider1D(1, 0.0f, AXIS_Z, false);
-	_slideZDetector->SetSliderSize(150.0f); // default=250.0; mm
-	_slideZDetector->SetBorderWidth(0.0f); // default=0.0
-	_slideZDetector->SetHysteresisRatio(0.5f); // default=0.5
-	_slideZDetector->SetValueChangeOnOffAxis(false); // default=false
-	_slideZDetector->RegisterValueChange(this, &SensorThread::onSlideZ);
-	_pointDenoiser->AddListener(_slideZDetector);
-
-	_swipeDetector = new XnVSwipeDetector();
-	_swipeDetector->SetUseSteady(true); // default=true
-	_swipeDetector->SetSteadyDuration(200); // default=200; ms
-	_swipeDetector->SetSteadyMaxStdDev(0.01f); // default=0.01; m/sec
-	_swipeDetector->SetMotionTime(200); // default=350; ms
-	_swipeDetector->SetMotionSpeedThreshold(0.4f); // default=0.25; m/sec
-	_swipeDetector->SetXAngleThreshold(25.0f); // default=25.0; deg
-	_swipeDetector->SetYAngleThreshold(20.0f); // default=20.0; deg
-	_swipeDetector->RegisterSwipe(this, &SensorThread::onSwipe);
-	_pointDenoiser->AddListener(_swipeDetector);
-
-	_pushDetector = new XnVPushDetector();
-	_pushDetector->SetPushImmediateOffset(0); // default=0; ms
-	_pushDetector->SetPushImmediateDuration(240); // default=240; ms
-	_pushDetector->SetPushImmediateMinimumVelocity(0.33f); // default=0.33; m/sec
-	_pushDetector->SetPushMaximumAngleBetweenImmediateAndZ(30.0f); // default=30.0; deg
-	_pushDetector->SetPushPreviousOffset(240); // default=240; ms
-	_pushDetector->SetPushPreviousDuration(150); // default=150; ms
-	_pushDetector->SetPushPreviousMinimumVelocity(0.17f); // default=0.17; m/sec
-	_pushDetector->SetPushMinimumAngleBetweenImmediateAndPrevious(20.0f); // default=20.0; deg
-	_pushDetector->SetStableDuration(240); // default=360; ms
-	_pushDetector->SetStableMaximumVelocity(0.13f); // default=0.13; m/sec
-	_pushDetector->RegisterPush(this, &SensorThread::onPush);
-	_pointDenoiser->AddListener(_pushDetector);
-
-	_waveDetector = new XnVWaveDetector();
-	_waveDetector->SetFlipCount(8); // default=4
-	_waveDetector->SetMaxDeviation(50); // default=50; mm
-	_waveDetector->SetMinLength(50); // default=50; mm
-	_waveDetector->RegisterWave(this, &SensorThread::onWave);
-	_pointDenoiser->AddListener(_waveDetector);
-}
-
-void SensorThread::killSession()
-{
-	if (!_sessionManager)
-		return;
-
-	_pointDenoiser->RemoveListener(_waveDetector);
-	delete _waveDetector;
-	_pointDenoiser->RemoveListener(_pushDetector);
-	delete _pushDetector;
-	_pointDenoiser->RemoveListener(_swipeDetector);
-	delete _swipeDetector;
-	_pointDenoiser->RemoveListener(_slideZDetector);
-	delete _slideZDetector;
-	_pointDenoiser->RemoveListener(_slideYDetector);
-	delete _slideYDetector;
-	_pointDenoiser->RemoveListener(_slideXDetector);
-	delete _slideXDetector;
-	_pointDenoiser->RemoveListener(_circleDetector);
-	delete _circleDetector;
-	_pointDenoiser->RemoveListener(_steadyDetector);
-	delete _steadyDetector;
-
-	_sessionManager->RemoveListener(_pointDenoiser);
-	delete _pointDenoiser;
-
-	blockSignals(true);
-	_sessionManager->EndSession();
-//	onSessionEnd(this);
-	delete _sessionManager;
-	blockSignals(false);
-}
-
-void SensorThread::killContext()
-{
-	_context->StopGeneratingAll();
-	_context->Release();
-}
-
-SensorThread::State SensorThread::getState() const
-{
-	QMutexLocker l(&_stateMutex);
-
-	return _state;
-}
-
-void SensorThread::setState(State state)
-{
-	QMutexLocker l(&_stateMutex);
-
-	_s1 = state;
-}
-
-void SensorThread::run()
-{
-	_context = new xn::Context();
-
-	initState();
-
-	while (getState() != STATE_QUIT)
-	{
-		msleep(0);
-
-		update();
-	}
-
-	killSession();
-	killContext();
-
-	delete _context;
-}
-
-void SensorThread::update()
-{
-	State state = STATE_NONE;
-
-	{
-		QMutexLocker l(&_stateMutex);
-
-		if (_s1 != _state)
-		{
-			onStateLeave(_state);
-			_state = _s1;
-			onStateEnter(_state);
-		}
-
-		state = _state;
-	}
-
-	if (!state)
-	{
-		setState(STATE_CONNECT);
-	}
-	else if (state == STATE_CONNECT)
-	{
-		emit evConnectBegin();
-
-		xn::ScriptNode scriptNode;
-		XnStatus result = _context->InitFromXmlFile(CONFIG, scriptNode);
-		if (result != XN_STATUS_OK)
-		{
-			emit evConnectError();
-			msleep(3000);
-			return;
-		}
-		else
-		{
-			emit evConnect();
-		}
-
-		initContext();
-		initSession();
-
-		setState(STATE_CAPTURE);
-	}
-	else if (state == STATE_CAPTURE)
-	{
-		XnStatus result = _context->WaitAndUpdateAll();
-		if (result != XN_STATUS_OK)
-		{
-			emit evDisconnect();
-
-			setState(STATE_QUIT);
-			return;
-		}
-		
-		_sessionManager->Update(_context);
-
-		if (_imageGenerator)
-			onImageMap();
-		else
-			onDepthMap();
-	}
-	else if (state == STATE_QUIT)
-	{
-	}
-}
-
-void SensorThread::onStateEnter(State state)
-{
-	// Prevent "unreferenced formal parameter" warning
-	state;
-}
-
-void SensorThread::onStateLeave(State state)
-{
-	// Prevent "unreferenced formal parameter" warning
-	state;
-}
-
-void XN_CALLBACK_TYPE SensorThread::onNewUser(xn::UserGenerator& generator, XnUserID user, void* self)
-{
-	// Prevent "unreferenced formal parameter" warning
-	generator;
-	user;
-
-	emit static_cast<SensorThread*>(self)->evUserEnter();
-}
-
-void XN_CALLBACK_TYPE SensorThread::onLostUser(xn::UserGenerator& generator, XnUserID user, void* self)
-{
-	// Prevent "unreferenced formal parameter" warning
-	generator;
-	user;
-
-	emit static_cast<SensorThread*>(self)->evUserLeave();
-}
-
-void XN_CALLBACK_TYPE SensorThread::onSessionStart(const XnPoint3D& position, void* self)
-{
-	// Prevent "unreferenced formal parameter" warning
-	position;
-
-	emit static_cast<SensorThread*>(self)->evSessionBegin();
-}
-
-void XN_CALLBACK_TYPE SensorThread::onSessionEnd(void* self)
-{
-	emit static_cast<SensorThread*>(self)->evSessionEnd();
-}
-
-void XN_CALLBACK_TYPE SensorThread::onPrimaryPointCreate(const XnVHandPointContext* hand, const XnPoint3D& position, void* self)
-{
-	// Prevent "unreferenced formal parameter" warning
-	hand;
-	position;
-
-	emit static_cast<SensorThread*>(self)->evFocusGain();
-}
-
-void XN_CALLBACK_TYPE SensorThread::onPrimaryPointDestroy(XnUInt32 id, void* self)
-{
-	// Prevent "unreferenced formal parameter" warning
-	id;
-
-	emit static_cast<SensorThread*>(self)->evFocusLose();
-}
-
-void XN_CALLBACK_TYPE SensorThread::onPrimaryPointReplace(XnUInt32 id, const XnVHandPointContext* hand, void* self)
-{
-	// Prevent "unreferenced formal parameter" warning
-	id;
-	hand;
-
-	emit static_cast<SensorThread*>(self)->evFocusSwap();
-}
-
-void XN_CALLBACK_TYPE SensorThread::onSteady(XnUInt32 id, XnFloat standardDeviation, void* self)
-{
-	// Prevent "unreferenced formal parameter" warning
-	id;
-	standardDeviation;
-
-	static_cast<SensorThread*>(self)->_circleDetector->Reset();
-
-	emit static_cast<SensorThread*>(self)->evSteadyBegin();
-}
-
-void XN_CALLBACK_TYPE SensorThread::onNotSteady(XnUInt32 id, XnFloat standardDeviation, void* self)
-{
-	// Prevent "unreferenced formal parameter" warning
-	id;
-	standardDeviation;
-
-	emit static_cast<SensorThread*>(self)->evSteadyEnd();
-}
-
-void XN_CALLBACK_TYPE SensorThread::onCircle(XnFloat count, XnBool confidence, const XnVCircle* circle, void* self)
-{
-	// Prevent "unreferenced formal parameter" warning
-	confidence;
-	circle;
-
-	int& _c0 = static_cast<SensorThread*>(self)->_c0;
-
-	if (!count)
-	{
-		_c0 = 0;
-	}
-	else
-	{
-		int d = count - _c0;
-		if (d)
-		{
-			_c0 = count;
-			emit static_cast<SensorThread*>(self)->evCircle(d);
-		}
-	}
-}
-
-void XN_CALLBACK_TYPE SensorThread::onSlideX(XnFloat value, void* self)
-{
-	emit static_cast<SensorThread*>(self)->evSlideX((value - 0.5f) * 2.0f);
-}
-
-void XN_CALLBACK_TYPE SensorThread::onSlideY(XnFloat value, void* self)
-{
-	emit static_cast<SensorThread*>(self)->evSlideY((value - 0.5f) * 2.0f);
-}
-
-void XN_CALLBACK_TYPE SensorThread::onSlideZ(XnFloat value, void* self)
-{
-	emit static_cast<SensorThread*>(self)->evSlideZ((value - 0.5f) * 2.0f);
-}
-
-void XN_CALLBACK_TYPE SensorThread::onSwipe(XnVDirection direction, XnFloat speed, XnFloat angle, void* self)
-{
-	if (direction == DIRECTION_DOWN)
-	{
-		emit static_cast<SensorThread*>(self)->evSwipeY(-1, speed, angle);
-	}
-	else if (direction == DIRECTION_UP)
-	{
-		emit static_cast<SensorThread*>(self)->evSwipeY(1, speed, angle);
-	}
-	else if (direction == DIRECTION_LEFT)
-	{
-		emit static_cast<SensorThread*>(self)->evSwipeX(-1, speed, angle);
-	}
-	else if (direction == DIRECTION_RIGHT)
-	{
-		emit static_cast<SensorThread*>(self)->evSwipeX(1, speed, angle);
-	}
-}
-
-void XN_CALLBACK_TYPE SensorThread::onPush(XnFloat speed, XnFloat angle, void* self)
-{
-	emit static_cast<SensorThread*>(self)->evPush(speed, angle);
-}
-
-void XN_CALLBACK_TYPE SensorThread::onWave(void* self)
-{
-	emit static_cast<SensorThread*>(self)->evWave();
-}
-
-void SensorThread::onDepthMap()
-{
-	xn::DepthMetaData depthMetaData;
-	_depthGenerator.GetMetaData(depthMetaData);
-	const XnDepthPixel* src = depthMetaData.Data();
-
-	xn::SceneMetaData sceneMetaData;
-	_userGenerator.GetUserPixels(0, sceneMetaData);
-	const XnLabel* usr = sceneMetaData.Data();
-
-//	// Too slow? Seems to prevent wave focus gesture from being recognized
-//
-//	_depthHistogram.fill(0);
-//
-//	const XnDepthPixel* depth = src;
-//	int total = 0;
-//	for (int i = 0, il = depthMetaData.XRes() * depthMetaData.YRes(); i < il; ++i)
-//	{
-//		if (*depth)
-//		{
-//			++_depthHistogram[*depth];
-//			++total;
-//		}
-//
-//		++depth;
-//	}
-//
-//	if (total)
-//	{
-//		for (int i = 1, il = _depthHistogram.size(); i < il; ++i)
-//		{
-//			_depthHistogram[i] += _depthHistogram[i - 1];
-//		}
-//
-//		for (int i = 0, il = _depthHistogram.size(); i < il; ++i)
-//		{
-//			_depthHistogram[i] = 0xC0 * (1.0f - (_depthHistogram[i] / static_cast<qreal>(total)));
-//		}
-//	}
-//	
-//	// Copy pixels occupied by users, set unoccupied pixels to transparent
-//	QRgb* dst = reinterpret_cast<QRgb*>(_usersMap.bits());
-//	for (int i = 0, il = _usersMap.width() * _usersMap.height(); i < il; ++i)
-//	{
-//		*dst = (*usr)
-//			? qRgba(_depthHistogram[*src], _depthHistogram[*src], _depthHistogram[*src], 0xFF)
-//			: 0x00000000;
-//
-//		++usr;
-//		++src;
-//		++dst;
-//	}
-
-	// Copy pixels occupied by users, set unoccupied pixels to transparent
-	QRgb* dst = reinterpret_cast<QRgb*>(_usersMap.bits());
-	for (int i = 0, il = _usersMap.width() * _usersMap.height(); i < il; ++i)
-	{
-		int n = 0xC0 * (1.0f - ((qMin<XnDepthPixel>(qMax<XnDepthPixel>(*src, DEPTH_MIN), DEPTH_MAX) - DEPTH_MIN) / static_cast<qreal>(DEPTH_MAX - DEPTH_MIN)));
-
-		*dst = (*usr)
-			? qRgba(n, n, n, 0xFF)
-			: 0x00000000;
-
-		++usr;
-		++src;
-		++dst;
-	}
-
-	emit evUsersMap(_usersMap);
-}
-
-void SensorThread::onImageMap()
-{
-	xn::ImageMetaData imageMetaData;
-	_imageGenerator.GetMetaData(imageMetaData);
-	const XnRGB24Pixel* src = imageMetaData.RGB24Data();
-
-	xn::SceneMetaData sceneMetaData;
-	_userGenerator.GetUserPixels(0, sceneMetaData);
-	const XnLabel* usr = sceneMetaData.Data();
-	
-	// Copy pixels occupied by users, set unoccupied pixels to transparent
-	QRgb* dst = reinterpret_cast<QRgb*>(_usersMap.bits());
-	for (int i = 0, il = _usersMap.width() * _usersMap.height(); i < il; ++i)
-	{
-		*dst = (*usr)
-			? qRgba((*src).nRed, (*src).nGreen, (*src).nBlue, 0xFF)
-			: 0x00000000;
-
-		++usr;
-		++src;
-		++dst;
-	}
-
-	emit evUsersMap(_usersMap);
-}
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SensorThread.h"
+
+#include "SensorRecording.h"
+#include "AvatarPipeline.h"
+#include "GestureRecognizer.h"
+#include "HandFilter.h"
+
+const char* SensorThread::CONFIG = "./OpenNI.xml";
+
+const int SensorThread::HISTOGRAM_SHIFT = 4; // 16mm per bin
+const int SensorThread::HISTOGRAM_BINS = 0x10000 >> HISTOGRAM_SHIFT;
+const int SensorThread::HISTOGRAM_BUDGET = 32768; // px per frame
+const float SensorThread::HISTOGRAM_WEIGHT = 0.25f;
+
+const int SensorThread::AVATAR_MARGIN = 8; // px
+
+SensorThread::SensorThread(QObject* parent)
+	: InputSource(parent)
+{
+	init();
+}
+
+SensorThread::~SensorThread()
+{
+	setState(STATE_QUIT);
+
+	// Wait for run method to return
+	wait();
+
+	delete _avatarPipeline;
+}
+
+void SensorThread::init()
+{
+	_context = NULL;
+
+	_sessionManager = NULL;
+	_pointControl = NULL;
+	_pointDenoiser = NULL;
+	_steadyDetector = NULL;
+	_circleDetector = NULL;
+	_slideXDetector = NULL;
+	_slideYDetector = NULL;
+	_slideZDetector = NULL;
+	_swipeDetector = NULL;
+	_pushDetector = NULL;
+	_waveDetector = NULL;
+	_detectorMask = 0;
+
+	_depthCounts.fill(0, HISTOGRAM_BINS * 4);
+	_depthHistogram.fill(0.0f, HISTOGRAM_BINS);
+	_depthLookup.fill(qRgba(0xC0, 0xC0, 0xC0, 0xFF), HISTOGRAM_BINS);
+	_depthPhase = 0;
+
+	// Hand the avatar straight on from whichever worker finishes it
+	_avatarPipeline = new AvatarPipeline(NULL);
+	QObject::connect(_avatarPipeline, SIGNAL(evUsersMap(QImage, QPoint, QSize)), this, SIGNAL(evUsersMap(QImage, QPoint, QSize)), Qt::DirectConnection);
+
+	_playbackRate = 1.0f;
+	_nativeGestures = false;
+	_handFiltered = true;
+	_depthOnly = false;
+	_captureMode.nXRes = 0;
+	_captureMode.nYRes = 0;
+	_captureMode.nFPS = 0;
+	_imageMatched = true;
+
+	_gestureRecognizer = NULL;
+	_handFilter = NULL;
+
+	// Emptied every frame with resize(0), which keeps reserved storage where clear() frees it
+	_gestures.reserve(PACKET_EVENTS);
+	_events.reserve(PACKET_EVENTS);
+
+	_recording = NULL;
+	_timestamp = 0;
+
+	_playbackFrame = 0;
+	_playbackTimestamp = 0;
+
+	_c0 = 0;
+
+	initState();
+}
+
+void SensorThread::initState()
+{
+	_state = STATE_NONE;
+	_s1 = STATE_NONE;
+}
+
+void SensorThread::initContext()
+{
+	_context->FindExistingNode(XN_NODE_TYPE_DEPTH, _depthGenerator);
+
+	if (_context->FindExistingNode(XN_NODE_TYPE_IMAGE, _imageGenerator) != XN_STATUS_OK)
+	{
+		_imageGenerator = NULL;
+	}
+
+	_context->FindExistingNode(XN_NODE_TYPE_USER, _userGenerator);
+
+	XnCallbackHandle handle;
+	_userGenerator.RegisterUserCallbacks(&SensorThread::onNewUser, &SensorThread::onLostUser, this, handle);
+
+	// Modes the depth can be captured in, e.g. to trade resolution for rate
+	XnUInt32 count = _depthGenerator.GetSupportedMapOutputModesCount();
+	QVector<XnMapOutputMode> modes(count);
+	if ((count)
+		&& (_depthGenerator.GetSupportedMapOutputModes(modes.data(), count) == XN_STATUS_OK))
+	{
+		modes.resize(count);
+	}
+	else
+	{
+		modes.clear();
+	}
+
+	XnMapOutputMode mode;
+	_depthGenerator.GetMapOutputMode(mode);
+	{
+		QMutexLocker l(&_configMutex);
+
+		_captureModes = modes;
+		if (!_captureMode.nXRes)
+			_captureMode = mode;
+	}
+
+	_imageMatched = true;
+	updateMode();
+
+	// Everything but the image, which only streams when the avatar is in color
+	xn::HandsGenerator handsGenerator;
+	xn::GestureGenerator gestureGenerator;
+
+	_depthGenerator.StartGenerating();
+	_userGenerator.StartGenerating();
+	if (_context->FindExistingNode(XN_NODE_TYPE_HANDS, handsGenerator) == XN_STATUS_OK)
+		handsGenerator.StartGenerating();
+	if (_context->FindExistingNode(XN_NODE_TYPE_GESTURE, gestureGenerator) == XN_STATUS_OK)
+		gestureGenerator.StartGenerating();
+
+	updateImage();
+}
+
+void SensorThread::initSession()
+{
+	_sessionManager = new XnVSessionManager();
+	_sessionManager->Initialize(_context, "Wave", "");
+	_sessionManager->SetQuickRefocusTimeout(1500); // default=15000; ms
+	_sessionManager->RegisterSession(this, &SensorThread::onSessionStart, &SensorThread::onSessionEnd);
+
+	// Raw primary hand point, before denoising
+	_pointControl = new XnVPointControl();
+	_pointControl->RegisterPrimaryPointUpdate(this, &SensorThread::onPrimaryPointUpdate);
+	_sessionManager->AddListener(_pointControl);
+
+	_pointDenoiser = new XnVPointDenoiser();
+	_pointDenoiser->SetDistanceThreshold(10.0f); // default=10.0; mm
+	_pointDenoiser->SetCloseRatio(0.0f); // default=0.0
+	_pointDenoiser->SetFarRatio(1.0f); // default=1.0
+	_pointDenoiser->RegisterPrimaryPointCreate(this, &SensorThread::onPrimaryPointCreate);
+	_pointDenoiser->RegisterPrimaryPointDestroy(this, &SensorThread::onPrimaryPointDestroy);
+	_pointDenoiser->RegisterPrimaryPointReplace(this, &SensorThread::onPrimaryPointReplace);
+	_sessionManager->AddListener(_pointDenoiser);
+
+	_steadyDetector = new XnVSteadyDetector();
+	_steadyDetector->SetDetectionDuration(200); // default=200; ms
+	_steadyDetector->SetMaximumStdDevForSteady(0.01f); // default=0.01; m/sec
+	_steadyDetector->SetMinimumStdDevForNotSteady(0.02f); // default=0.02; m/sec
+	_steadyDetector->RegisterSteady(this, &SensorThread::onSteady);
+	_steadyDetector->RegisterNotSteady(this, &SensorThread::onNotSteady);
+
+	_circleDetector = new XnVCircleDetector();
+	_circleDetector->SetMinRadius(40.0f); // default=40.0; mm
+	_circleDetector->SetMaxRadius(1200.0f); // default=1200.0; mm
+	_circleDetector->SetExistingWeight(0.8f); // default=0.8
+	_circleDetector->SetCloseToExistingRadius(50.0f); // default=50.0; mm
+	_circleDetector->SetCloseEnough(1000.0f); // default=1000; mm^2
+	_circleDetector->SetMinimumPoints(20); // default=20
+	_circleDetector->SetMaxErrors(5); // default=5
+	_circleDetector->RegisterCircle(this, &SensorThread::onCircle);
+
+	_slideXDetector = new XnVSelectableSlider1D(1, 0.0f, AXIS_X, false);
+	_slideXDetector->SetSliderSize(150.0f); // default=250.0; mm
+	_slideXDetector->SetBorderWidth(0.0f); // default=0.0
+	_slideXDetector->SetHysteresisRatio(0.5f); // default=0.5
+	_slideXDetector->SetValueChangeOnOffAxis(false); // default=false
+	_slideXDetector->RegisterValueChange(this, &SensorThread::onSlideX);
+
+	_slideYDetector = new XnVSelectableSlider1D(1, 0.0f, AXIS_Y, false);
+	_slideYDetector->SetSliderSize(150.0f); // default=250.0; mm
+	_slideYDetector->SetBorderWidth(0.0f); // default=0.0
+	_slideYDetector->SetHysteresisRatio(0.5f); // default=0.5
+	_slideYDetector->SetValueChangeOnOffAxis(false); // default=false
+	_slideYDetector->RegisterValueChange(this, &SensorThread::onSlideY);
+
+	_slideZDetector = new XnVSelectableSlider1D(1, 0.0f, AXIS_Z, false);
+	_slideZDetector->SetSliderSize(150.0f); // default=250.0; mm
+	_slideZDetector->SetBorderWidth(0.0f); // default=0.0
+	_slideZDetector->SetHysteresisRatio(0.5f); // default=0.5
+	_slideZDetector->SetValueChangeOnOffAxis(false); // default=false
+	_slideZDetector->RegisterValueChange(this, &SensorThread::onSlideZ);
+
+	_swipeDetector = new XnVSwipeDetector();
+	_swipeDetector->SetUseSteady(true); // default=true
+	_swipeDetector->SetSteadyDuration(200); // default=200; ms
+	_swipeDetector->SetSteadyMaxStdDev(0.01f); // default=0.01; m/sec
+	_swipeDetector->SetMotionTime(200); // default=350; ms
+	_swipeDetector->SetMotionSpeedThreshold(0.4f); // default=0.25; m/sec
+	_swipeDetector->SetXAngleThreshold(25.0f); // default=25.0; deg
+	_swipeDetector->SetYAngleThreshold(20.0f); // default=20.0; deg
+	_swipeDetector->RegisterSwipe(this, &SensorThread::onSwipe);
+
+	_pushDetector = new XnVPushDetector();
+	_pushDetector->SetPushImmediateOffset(0); // default=0; ms
+	_pushDetector->SetPushImmediateDuration(240); // default=240; ms
+	_pushDetector->SetPushImmediateMinimumVelocity(0.33f); // default=0.33; m/sec
+	_pushDetector->SetPushMaximumAngleBetweenImmediateAndZ(30.0f); // default=30.0; deg
+	_pushDetector->SetPushPreviousOffset(240); // default=240; ms
+	_pushDetector->SetPushPreviousDuration(150); // default=150; ms
+	_pushDetector->SetPushPreviousMinimumVelocity(0.17f); // default=0.17; m/sec
+	_pushDetector->SetPushMinimumAngleBetweenImmediateAndPrevious(20.0f); // default=20.0; deg
+	_pushDetector->SetStableDuration(240); // default=360; ms
+	_pushDetector->SetStableMaximumVelocity(0.13f); // default=0.13; m/sec
+	_pushDetector->RegisterPush(this, &SensorThread::onPush);
+
+	_waveDetector = new XnVWaveDetector();
+	_waveDetector->SetFlipCount(8); // default=4
+	_waveDetector->SetMaxDeviation(50); // default=50; mm
+	_waveDetector->SetMinLength(50); // default=50; mm
+	_waveDetector->RegisterWave(this, &SensorThread::onWave);
+
+	// Only those the game needs, see updateDetectors
+	_detectorMask = 0;
+	updateDetectors(getGestureMask());
+}
+
+void SensorThread::initGestures()
+{
+	// Slides, swipes, circles and pushes from our own recognizer instead of NITE
+	if ((getNativeGestures())
+		&& (!_gestureRecognizer))
+	{
+		_gestureRecognizer = new GestureRecognizer();
+	}
+
+	// Our own path for the hand point, instead of through the denoiser
+	if ((getHandFiltered())
+		&& (!_handFilter))
+	{
+		_handFilter = new HandFilter();
+	}
+}
+
+void SensorThread::initRecording()
+{
+	QString path = getRecordPath();
+	if (path.isEmpty())
+		return;
+
+	_recording = new SensorRecording();
+	if (!_recording->open(path, QIODevice::WriteOnly))
+	{
+		qWarning() << "Unable to open sensor recording for writing:" << path;
+
+		killRecording();
+	}
+}
+
+bool SensorThread::initPlayback()
+{
+	_recording = new SensorRecording();
+	if (!_recording->open(getPlaybackPath(), QIODevice::ReadOnly))
+	{
+		killRecording();
+		return false;
+	}
+
+	_timestamp = 0;
+
+	_playbackFrame = 0;
+	_playbackTimestamp = 0;
+	_playbackTimer.invalidate();
+
+	return true;
+}
+
+void SensorThread::killSession()
+{
+	if (!_sessionManager)
+		return;
+
+	updateDetectors(0);
+
+	delete _waveDetector;
+	delete _pushDetector;
+	delete _swipeDetector;
+	delete _slideZDetector;
+	delete _slideYDetector;
+	delete _slideXDetector;
+	delete _circleDetector;
+	delete _steadyDetector;
+
+	_sessionManager->RemoveListener(_pointDenoiser);
+	delete _pointDenoiser;
+
+	_sessionManager->RemoveListener(_pointControl);
+	delete _pointControl;
+
+	_sessionManager->EndSession();
+	delete _sessionManager;
+
+	// Nothing the torn down session reported is meant for the game
+	discard();
+}
+
+void SensorThread::killContext()
+{
+	_context->StopGeneratingAll();
+	_context->Release();
+}
+
+void SensorThread::killGestures()
+{
+	delete _gestureRecognizer;
+	_gestureRecognizer = NULL;
+
+	delete _handFilter;
+	_handFilter = NULL;
+}
+
+void SensorThread::killRecording()
+{
+	delete _recording;
+	_recording = NULL;
+
+	_events.resize(0);
+}
+
+SensorThread::State SensorThread::getState() const
+{
+	QMutexLocker l(&_stateMutex);
+
+	return _state;
+}
+
+void SensorThread::setState(State state)
+{
+	QMutexLocker l(&_stateMutex);
+
+	_s1 = state;
+}
+
+QString SensorThread::getRecordPath() const
+{
+	QMutexLocker l(&_configMutex);
+
+	return _recordPath;
+}
+
+void SensorThread::setRecordPath(const QString& path)
+{
+	QMutexLocker l(&_configMutex);
+
+	_recordPath = path;
+}
+
+QString SensorThread::getPlaybackPath() const
+{
+	QMutexLocker l(&_configMutex);
+
+	return _playbackPath;
+}
+
+void SensorThread::setPlaybackPath(const QString& path, qreal rate)
+{
+	QMutexLocker l(&_configMutex);
+
+	_playbackPath = path;
+	_playbackRate = rate;
+}
+
+bool SensorThread::getNativeGestures() const
+{
+	QMutexLocker l(&_configMutex);
+
+	return _nativeGestures;
+}
+
+void SensorThread::setNativeGestures(bool native)
+{
+	QMutexLocker l(&_configMutex);
+
+	_nativeGestures = native;
+}
+
+bool SensorThread::getHandFiltered() const
+{
+	QMutexLocker l(&_configMutex);
+
+	return _handFiltered;
+}
+
+void SensorThread::setHandFiltered(bool filtered)
+{
+	QMutexLocker l(&_configMutex);
+
+	_handFiltered = filtered;
+}
+
+bool SensorThread::getDepthOnly() const
+{
+	QMutexLocker l(&_configMutex);
+
+	return _depthOnly;
+}
+
+void SensorThread::setDepthOnly(bool depthOnly)
+{
+	QMutexLocker l(&_configMutex);
+
+	_depthOnly = depthOnly;
+}
+
+QVector<XnMapOutputMode> SensorThread::getCaptureModes() const
+{
+	QMutexLocker l(&_configMutex);
+
+	return _captureModes;
+}
+
+XnMapOutputMode SensorThread::getCaptureMode() const
+{
+	QMutexLocker l(&_configMutex);
+
+	return _captureMode;
+}
+
+void SensorThread::setCaptureMode(const XnMapOutputMode& mode)
+{
+	QMutexLocker l(&_configMutex);
+
+	_captureMode = mode;
+}
+
+void SensorThread::run()
+{
+	_context = new xn::Context();
+
+	initState();
+
+	while (getState() != STATE_QUIT)
+	{
+		msleep(0);
+
+		update();
+	}
+
+	killRecording();
+	killGestures();
+
+	if (getPlaybackPath().isEmpty())
+	{
+		killSession();
+		killContext();
+	}
+
+	delete _context;
+}
+
+void SensorThread::update()
+{
+	State state = STATE_NONE;
+
+	{
+		QMutexLocker l(&_stateMutex);
+
+		if (_s1 != _state)
+		{
+			onStateLeave(_state);
+			_state = _s1;
+			onStateEnter(_state);
+		}
+
+		state = _state;
+	}
+
+	if (!state)
+	{
+		setState(STATE_CONNECT);
+	}
+	else if (state == STATE_CONNECT)
+	{
+		emit evConnectBegin();
+
+		// Play back a recording instead of connecting to a sensor
+		if (!getPlaybackPath().isEmpty())
+		{
+			initGestures();
+
+			if (!initPlayback())
+			{
+				emit evConnectError();
+				msleep(3000);
+				return;
+			}
+
+			emit evConnect();
+
+			setState(STATE_CAPTURE);
+			return;
+		}
+
+		xn::ScriptNode scriptNode;
+		XnStatus result = _context->InitFromXmlFile(CONFIG, scriptNode);
+		if (result != XN_STATUS_OK)
+		{
+			emit evConnectError();
+			msleep(3000);
+			return;
+		}
+		else
+		{
+			emit evConnect();
+		}
+
+		initContext();
+		initGestures();
+		initSession();
+		initRecording();
+
+		setState(STATE_CAPTURE);
+	}
+	else if (state == STATE_CAPTURE)
+	{
+		if ((_recording) && (_recording->isReadable()))
+		{
+			updatePlayback();
+			return;
+		}
+
+		updateDetectors(getGestureMask());
+		updateMode();
+		updateImage();
+
+		// Wake on depth alone, rather than wait for the slowest stream; gestures
+		// only need depth, the rest is updated with whatever it has by then
+		XnStatus result = _context->WaitOneUpdateAll(_depthGenerator);
+		if (result != XN_STATUS_OK)
+		{
+			emit evDisconnect();
+
+			setState(STATE_QUIT);
+			return;
+		}
+
+		qint64 captured = QDateTime::currentMSecsSinceEpoch();
+
+		_timestamp = _depthGenerator.GetTimestamp();
+		
+		_sessionManager->Update(_context);
+
+		// Everything the callbacks dispatched for this frame, in one go
+		flush(_timestamp, captured);
+
+		// Neither users nor avatar, unless the game shows it
+		if (!(getOutputs() & OUTPUT_AVATAR))
+		{
+		}
+		else if ((_imageGenerator)
+			&& (_imageGenerator.IsGenerating()))
+		{
+			// At the rate of the camera, which may be behind depth
+			if (_imageGenerator.IsDataNew())
+				onImageMap();
+		}
+		else
+		{
+			onDepthMap();
+		}
+
+		if (_recording)
+			updateRecording();
+	}
+	else if (state == STATE_QUIT)
+	{
+	}
+}
+
+void SensorThread::updateDetectors(quint32 mask)
+{
+	if (!_sessionManager)
+		return;
+
+	// Recognized from the hand point instead
+	if (_gestureRecognizer)
+	{
+		mask &= ~((1 << InputEvent::EVENT_CIRCLE)
+			| (1 << InputEvent::EVENT_SLIDE_X)
+			| (1 << InputEvent::EVENT_SLIDE_Y)
+			| (1 << InputEvent::EVENT_SLIDE_Z)
+			| (1 << InputEvent::EVENT_SWIPE_X)
+			| (1 << InputEvent::EVENT_SWIPE_Y)
+			| (1 << InputEvent::EVENT_PUSH));
+	}
+
+	// onSteady resets the circle detector, so it stays attached alongside
+	if (mask & (1 << InputEvent::EVENT_CIRCLE))
+	{
+		mask |= (1 << InputEvent::EVENT_STEADY_BEGIN) | (1 << InputEvent::EVENT_STEADY_END);
+	}
+
+	if (mask == _detectorMask)
+		return;
+
+	// Detectors not listening to the denoiser cost nothing per frame
+	updateDetector(_steadyDetector, mask, (1 << InputEvent::EVENT_STEADY_BEGIN) | (1 << InputEvent::EVENT_STEADY_END));
+	updateDetector(_circleDetector, mask, (1 << InputEvent::EVENT_CIRCLE));
+	updateDetector(_slideXDetector, mask, (1 << InputEvent::EVENT_SLIDE_X));
+	updateDetector(_slideYDetector, mask, (1 << InputEvent::EVENT_SLIDE_Y));
+	updateDetector(_slideZDetector, mask, (1 << InputEvent::EVENT_SLIDE_Z));
+	updateDetector(_swipeDetector, mask, (1 << InputEvent::EVENT_SWIPE_X) | (1 << InputEvent::EVENT_SWIPE_Y));
+	updateDetector(_pushDetector, mask, (1 << InputEvent::EVENT_PUSH));
+	updateDetector(_waveDetector, mask, (1 << InputEvent::EVENT_WAVE));
+
+	_detectorMask = mask;
+}
+
+void SensorThread::updateDetector(XnVMessageListener* detector, quint32 mask, quint32 gestures)
+{
+	bool listen = ((mask & gestures) != 0);
+	bool listening = ((_detectorMask & gestures) != 0);
+
+	if (listen == listening)
+		return;
+
+	if (listen)
+		_pointDenoiser->AddListener(detector);
+	else
+		_pointDenoiser->RemoveListener(detector);
+}
+
+void SensorThread::updateMode()
+{
+	XnMapOutputMode mode = getCaptureMode();
+	if (!mode.nXRes)
+		return;
+
+	XnMapOutputMode current;
+	_depthGenerator.GetMapOutputMode(current);
+	if (isEqual(mode, current))
+		return;
+
+	if (_depthGenerator.SetMapOutputMode(mode) != XN_STATUS_OK)
+	{
+		qWarning() << "Unsupported capture mode" << mode.nXRes << mode.nYRes << mode.nFPS;
+
+		// Stay as we are, rather than try again every frame
+		setCaptureMode(current);
+		return;
+	}
+
+	if (!_imageGenerator)
+		return;
+
+	// The avatar takes users from depth, so the image has to match it, or the
+	// avatar is shaded from depth until it does
+	_imageMatched = false;
+
+	XnUInt32 count = _imageGenerator.GetSupportedMapOutputModesCount();
+	QVector<XnMapOutputMode> modes(count);
+	if ((count)
+		&& (_imageGenerator.GetSupportedMapOutputModes(modes.data(), count) == XN_STATUS_OK))
+	{
+		for (XnUInt32 i = 0; i < count; ++i)
+		{
+			if (isEqual(modes[i], mode))
+			{
+				_imageMatched = (_imageGenerator.SetMapOutputMode(mode) == XN_STATUS_OK);
+				break;
+			}
+		}
+	}
+}
+
+void SensorThread::updateImage()
+{
+	if (!_imageGenerator)
+		return;
+
+	// Only stream the image for as long as the avatar is in color, it is as
+	// much bandwidth again as depth
+	bool generate = (!getDepthOnly()) && (_imageMatched);
+	if (generate == static_cast<bool>(_imageGenerator.IsGenerating()))
+		return;
+
+	if (generate)
+		_imageGenerator.StartGenerating();
+	else
+		_imageGenerator.StopGenerating();
+}
+
+void SensorThread::updatePlayback()
+{
+	SensorRecording::Frame frame;
+	if (!_recording->readFrame(_playbackFrame, frame))
+	{
+		// Nothing to play at all, e.g. an empty or corrupt recording
+		if (!_playbackFrame)
+		{
+			emit evDisconnect();
+
+			setState(STATE_QUIT);
+			return;
+		}
+
+		// End of recording, start over without the game seeing a disconnect
+		_timestamp = 0;
+
+		_playbackFrame = 0;
+		_playbackTimestamp = 0;
+		_playbackTimer.invalidate();
+
+		if (_handFilter)
+			_handFilter->reset();
+		if (_gestureRecognizer)
+			_gestureRecognizer->reset();
+		return;
+	}
+
+	++_playbackFrame;
+
+	// Restart the clock at the beginning, or where recordings were appended
+	if ((!_playbackTimer.isValid())
+		|| (frame.timestamp < _timestamp))
+	{
+		_playbackTimer.start();
+		_playbackTimestamp = frame.timestamp;
+	}
+
+	_timestamp = frame.timestamp;
+
+	// Pace frames as they were recorded, scaled by rate, or as fast as possible if rate is 0
+	qreal rate = 0.0f;
+	{
+		QMutexLocker l(&_configMutex);
+
+		rate = _playbackRate;
+	}
+
+	if (rate > 0.0f)
+	{
+		qint64 t = ((_timestamp - _playbackTimestamp) / (1000.0f * rate)) - _playbackTimer.elapsed();
+		if (t > 0)
+			msleep(t);
+	}
+
+	// As if captured now, so it is traced like a live frame
+	qint64 captured = QDateTime::currentMSecsSinceEpoch();
+
+	for (int i = 0; i < frame.eventCount; ++i)
+	{
+		dispatch(frame.events[i]);
+	}
+
+	flush(_timestamp, captured);
+
+	const XnLabel* usr = static_cast<const XnLabel*>(frame.data[SensorRecording::MAP_LABEL]);
+	if ((!usr)
+		|| (!(getOutputs() & OUTPUT_AVATAR)))
+	{
+		return;
+	}
+
+	// The label map is read at the other map's size, so a mismatch would overrun it
+	int xres = frame.xres[SensorRecording::MAP_LABEL];
+	int yres = frame.yres[SensorRecording::MAP_LABEL];
+
+	if ((frame.data[SensorRecording::MAP_IMAGE])
+		&& (!getDepthOnly())
+		&& (frame.xres[SensorRecording::MAP_IMAGE] == xres)
+		&& (frame.yres[SensorRecording::MAP_IMAGE] == yres))
+	{
+		onImageMap(static_cast<const XnRGB24Pixel*>(frame.data[SensorRecording::MAP_IMAGE]), usr,
+			frame.xres[SensorRecording::MAP_IMAGE], frame.yres[SensorRecording::MAP_IMAGE]);
+	}
+	else if ((frame.data[SensorRecording::MAP_DEPTH])
+		&& (frame.xres[SensorRecording::MAP_DEPTH] == xres)
+		&& (frame.yres[SensorRecording::MAP_DEPTH] == yres))
+	{
+		onDepthMap(static_cast<const XnDepthPixel*>(frame.data[SensorRecording::MAP_DEPTH]), usr,
+			frame.xres[SensorRecording::MAP_DEPTH], frame.yres[SensorRecording::MAP_DEPTH]);
+	}
+}
+
+void SensorThread::updateRecording()
+{
+	SensorRecording::Frame frame;
+	frame.timestamp = _timestamp;
+	frame.eventCount = _events.count();
+	frame.events = _events.constData();
+
+	xn::DepthMetaData depthMetaData;
+	_depthGenerator.GetMetaData(depthMetaData);
+	frame.xres[SensorRecording::MAP_DEPTH] = depthMetaData.XRes();
+	frame.yres[SensorRecording::MAP_DEPTH] = depthMetaData.YRes();
+	frame.data[SensorRecording::MAP_DEPTH] = depthMetaData.Data();
+
+	xn::ImageMetaData imageMetaData;
+	if ((_imageGenerator)
+		&& (_imageGenerator.IsGenerating()))
+	{
+		_imageGenerator.GetMetaData(imageMetaData);
+		frame.xres[SensorRecording::MAP_IMAGE] = imageMetaData.XRes();
+		frame.yres[SensorRecording::MAP_IMAGE] = imageMetaData.YRes();
+		frame.data[SensorRecording::MAP_IMAGE] = imageMetaData.RGB24Data();
+	}
+	else
+	{
+		frame.xres[SensorRecording::MAP_IMAGE] = 0;
+		frame.yres[SensorRecording::MAP_IMAGE] = 0;
+		frame.data[SensorRecording::MAP_IMAGE] = NULL;
+	}
+
+	xn::SceneMetaData sceneMetaData;
+	_userGenerator.GetUserPixels(0, sceneMetaData);
+	frame.xres[SensorRecording::MAP_LABEL] = sceneMetaData.XRes();
+	frame.yres[SensorRecording::MAP_LABEL] = sceneMetaData.YRes();
+	frame.data[SensorRecording::MAP_LABEL] = sceneMetaData.Data();
+
+	frame.xres[SensorRecording::MAP_NONE] = 0;
+	frame.yres[SensorRecording::MAP_NONE] = 0;
+	frame.data[SensorRecording::MAP_NONE] = NULL;
+
+	if (!_recording->writeFrame(frame))
+	{
+		qWarning() << "Unable to write sensor recording, stopping.";
+
+		killRecording();
+	}
+
+	_events.resize(0);
+}
+
+void SensorThread::dispatch(const InputEvent& event)
+{
+	if ((event.type == InputEvent::EVENT_SESSION_END)
+		|| (event.type == InputEvent::EVENT_FOCUS_GAIN)
+		|| (event.type == InputEvent::EVENT_FOCUS_LOSE))
+	{
+		if (_gestureRecognizer)
+			_gestureRecognizer->reset();
+
+		if (_handFilter)
+			_handFilter->reset();
+	}
+	else if ((_gestureRecognizer)
+		&& (event.type >= InputEvent::EVENT_CIRCLE)
+		&& (event.type <= InputEvent::EVENT_PUSH))
+	{
+		// Recognized from the hand point instead, e.g. when playing back
+		return;
+	}
+
+	// Keep events with the frame they occurred in, for recording; the hand
+	// point as captured, so it can be filtered differently on playback
+	if ((_recording) && (_recording->isWritable()))
+		_events << event;
+
+	if (event.type == InputEvent::EVENT_FOCUS_MOVE)
+	{
+		updateHand(event);
+		return;
+	}
+
+	InputSource::dispatch(event);
+}
+
+void SensorThread::updateHand(const InputEvent& event)
+{
+	InputEvent hand = event;
+
+	if (_handFilter)
+		_handFilter->update(hand.value, _timestamp);
+
+	HandPoint point = {_timestamp, {hand.value[0], hand.value[1], hand.value[2]}};
+	publish(point);
+
+	if (_gestureRecognizer)
+	{
+		_gestures.resize(0);
+		_gestureRecognizer->update(hand.value, _timestamp, _gestures);
+
+		for (int i = 0, il = _gestures.count(); i < il; ++i)
+		{
+			if ((_recording) && (_recording->isWritable()))
+				_events << _gestures[i];
+
+			InputSource::dispatch(_gestures[i]);
+		}
+	}
+}
+
+void SensorThread::onStateEnter(State state)
+{
+	// Prevent "unreferenced formal parameter" warning
+	state;
+}
+
+void SensorThread::onStateLeave(State state)
+{
+	// Prevent "unreferenced formal parameter" warning
+	state;
+}
+
+void XN_CALLBACK_TYPE SensorThread::onNewUser(xn::UserGenerator& generator, XnUserID user, void* self)
+{
+	// Prevent "unreferenced formal parameter" warning
+	generator;
+	user;
+
+	static_cast<SensorThread*>(self)->dispatch(InputEvent::EVENT_USER_ENTER);
+}
+
+void XN_CALLBACK_TYPE SensorThread::onLostUser(xn::UserGenerator& generator, XnUserID user, void* self)
+{
+	// Prevent "unreferenced formal parameter" warning
+	generator;
+	user;
+
+	static_cast<SensorThread*>(self)->dispatch(InputEvent::EVENT_USER_LEAVE);
+}
+
+void XN_CALLBACK_TYPE SensorThread::onSessionStart(const XnPoint3D& position, void* self)
+{
+	// Prevent "unreferenced formal parameter" warning
+	position;
+
+	static_cast<SensorThread*>(self)->dispatch(InputEvent::EVENT_SESSION_BEGIN);
+}
+
+void XN_CALLBACK_TYPE SensorThread::onSessionEnd(void* self)
+{
+	static_cast<SensorThread*>(self)->dispatch(InputEvent::EVENT_SESSION_END);
+}
+
+void XN_CALLBACK_TYPE SensorThread::onPrimaryPointCreate(const XnVHandPointContext* hand, const XnPoint3D& position, void* self)
+{
+	// Prevent "unreferenced formal parameter" warning
+	hand;
+	position;
+
+	static_cast<SensorThread*>(self)->dispatch(InputEvent::EVENT_FOCUS_GAIN);
+}
+
+void XN_CALLBACK_TYPE SensorThread::onPrimaryPointDestroy(XnUInt32 id, void* self)
+{
+	// Prevent "unreferenced formal parameter" warning
+	id;
+
+	static_cast<SensorThread*>(self)->dispatch(InputEvent::EVENT_FOCUS_LOSE);
+}
+
+void XN_CALLBACK_TYPE SensorThread::onPrimaryPointReplace(XnUInt32 id, const XnVHandPointContext* hand, void* self)
+{
+	// Prevent "unreferenced formal parameter" warning
+	id;
+	hand;
+
+	static_cast<SensorThread*>(self)->dispatch(InputEvent::EVENT_FOCUS_SWAP);
+}
+
+void XN_CALLBACK_TYPE SensorThread::onPrimaryPointUpdate(const XnVHandPointContext* hand, void* self)
+{
+	const XnPoint3D& p = hand->ptPosition;
+
+	static_cast<SensorThread*>(self)->dispatch(InputEvent::EVENT_FOCUS_MOVE, p.X, p.Y, p.Z);
+}
+
+void XN_CALLBACK_TYPE SensorThread::onSteady(XnUInt32 id, XnFloat standardDeviation, void* self)
+{
+	// Prevent "unreferenced formal parameter" warning
+	id;
+	standardDeviation;
+
+	static_cast<SensorThread*>(self)->_circleDetector->Reset();
+
+	static_cast<SensorThread*>(self)->dispatch(InputEvent::EVENT_STEADY_BEGIN);
+}
+
+void XN_CALLBACK_TYPE SensorThread::onNotSteady(XnUInt32 id, XnFloat standardDeviation, void* self)
+{
+	// Prevent "unreferenced formal parameter" warning
+	id;
+	standardDeviation;
+
+	static_cast<SensorThread*>(self)->dispatch(InputEvent::EVENT_STEADY_END);
+}
+
+void XN_CALLBACK_TYPE SensorThread::onCircle(XnFloat count, XnBool confidence, const XnVCircle* circle, void* self)
+{
+	// Prevent "unreferenced formal parameter" warning
+	confidence;
+	circle;
+
+	int& _c0 = static_cast<SensorThread*>(self)->_c0;
+
+	if (!count)
+	{
+		_c0 = 0;
+	}
+	else
+	{
+		int d = count - _c0;
+		if (d)
+		{
+			_c0 = count;
+			static_cast<SensorThread*>(self)->dispatch(InputEvent::EVENT_CIRCLE, d);
+		}
+	}
+}
+
+void XN_CALLBACK_TYPE SensorThread::onSlideX(XnFloat value, void* self)
+{
+	static_cast<SensorThread*>(self)->dispatch(InputEvent::EVENT_SLIDE_X, (value - 0.5f) * 2.0f);
+}
+
+void XN_CALLBACK_TYPE SensorThread::onSlideY(XnFloat value, void* self)
+{
+	static_cast<SensorThread*>(self)->dispatch(InputEvent::EVENT_SLIDE_Y, (value - 0.5f) * 2.0f);
+}
+
+void XN_CALLBACK_TYPE SensorThread::onSlideZ(XnFloat value, void* self)
+{
+	static_cast<SensorThread*>(self)->dispatch(InputEvent::EVENT_SLIDE_Z, (value - 0.5f) * 2.0f);
+}
+
+void XN_CALLBACK_TYPE SensorThread::onSwipe(XnVDirection direction, XnFloat speed, XnFloat angle, void* self)
+{
+	if (direction == DIRECTION_DOWN)
+	{
+		static_cast<SensorThread*>(self)->dispatch(InputEvent::EVENT_SWIPE_Y, -1, speed, angle);
+	}
+	else if (direction == DIRECTION_UP)
+	{
+		static_cast<SensorThread*>(self)->dispatch(InputEvent::EVENT_SWIPE_Y, 1, speed, angle);
+	}
+	else if (direction == DIRECTION_LEFT)
+	{
+		static_cast<SensorThread*>(self)->dispatch(InputEvent::EVENT_SWIPE_X, -1, speed, angle);
+	}
+	else if (direction == DIRECTION_RIGHT)
+	{
+		static_cast<SensorThread*>(self)->dispatch(InputEvent::EVENT_SWIPE_X, 1, speed, angle);
+	}
+}
+
+void XN_CALLBACK_TYPE SensorThread::onPush(XnFloat speed, XnFloat angle, void* self)
+{
+	static_cast<SensorThread*>(self)->dispatch(InputEvent::EVENT_PUSH, speed, angle);
+}
+
+void XN_CALLBACK_TYPE SensorThread::onWave(void* self)
+{
+	static_cast<SensorThread*>(self)->dispatch(InputEvent::EVENT_WAVE);
+}
+
+bool SensorThread::isEqual(const XnMapOutputMode& a, const XnMapOutputMode& b)
+{
+	return ((a.nXRes == b.nXRes)
+		&& (a.nYRes == b.nYRes)
+		&& (a.nFPS == b.nFPS));
+}
+
+QRect SensorThread::getAvatarRect(const QRect& rect, qreal scale) const
+{
+	int x0 = qFloor(rect.left() * scale);
+	int y0 = qFloor(rect.top() * scale);
+	int x1 = qCeil((rect.right() + 1) * scale);
+	int y1 = qCeil((rect.bottom() + 1) * scale);
+
+	return QRect(x0, y0, x1 - x0, y1 - y0);
+}
+
+QRect SensorThread::getUsersRect(const XnLabel* usr, int xres, int yres) const
+{
+	int x0 = xres;
+	int y0 = yres;
+	int x1 = -1;
+	int y1 = -1;
+
+	for (int y = 0; y < yres; ++y)
+	{
+		// Find leftmost pixel occupied by users
+		int x = 0;
+		while ((x < xres) && (!usr[x]))
+			++x;
+
+		if (x < xres)
+		{
+			// Find rightmost pixel occupied by users, beyond what we already have
+			int x2 = xres - 1;
+			while ((x2 > x1) && (!usr[x2]))
+				--x2;
+
+			x0 = qMin(x0, x);
+			x1 = qMax(x1, x2);
+			y0 = qMin(y0, y);
+			y1 = y;
+		}
+
+		usr += xres;
+	}
+
+	if (x1 < 0)
+		return QRect();
+
+	return QRect(QPoint(x0, y0), QPoint(x1, y1))
+		.adjusted(-AVATAR_MARGIN, -AVATAR_MARGIN, AVATAR_MARGIN, AVATAR_MARGIN)
+		.intersected(QRect(0, 0, xres, yres));
+}
+
+void SensorThread::initAvatarLookup(const QRect& rect, qreal scale, int xres, int yres)
+{
+	// Nearest source pixel for every row and column of the scaled region
+	_avatarRows.resize(rect.height());
+	for (int y = 0, yl = rect.height(); y < yl; ++y)
+	{
+		_avatarRows[y] = qMin(static_cast<int>((rect.top() + y + 0.5f) / scale), yres - 1);
+	}
+
+	_avatarCols.resize(rect.width());
+	for (int x = 0, xl = rect.width(); x < xl; ++x)
+	{
+		_avatarCols[x] = qMin(static_cast<int>((rect.left() + x + 0.5f) / scale), xres - 1);
+	}
+}
+
+void SensorThread::updateDepthHistogram(const XnDepthPixel* src, const XnLabel* usr, int xres, const QRect& rect)
+{
+	// Only sample every so many rows of the users each frame, a different set
+	// every frame, to stay within budget; the histogram carries over
+	int stride = qMax(1, (rect.width() * rect.height() + HISTOGRAM_BUDGET - 1) / HISTOGRAM_BUDGET);
+	_depthPhase = (_depthPhase + 1) % stride;
+
+	// Four histograms, so consecutive pixels don't wait on each other to count
+	_depthCounts.fill(0);
+	quint16* h0 = _depthCounts.data();
+	quint16* h1 = h0 + HISTOGRAM_BINS;
+	quint16* h2 = h1 + HISTOGRAM_BINS;
+	quint16* h3 = h2 + HISTOGRAM_BINS;
+
+	int total = 0;
+	for (int y = rect.top() + _depthPhase; y <= rect.bottom(); y += stride)
+	{
+		const XnDepthPixel* s = src + (y * xres) + rect.left();
+		const XnLabel* u = usr + (y * xres) + rect.left();
+
+		// Count only pixels occupied by users, with depth, without branching
+		int x = 0;
+		int xl = rect.width();
+		for (; x + 4 <= xl; x += 4)
+		{
+			int c0 = ((u[x] != 0) & (s[x] != 0));
+			int c1 = ((u[x + 1] != 0) & (s[x + 1] != 0));
+			int c2 = ((u[x + 2] != 0) & (s[x + 2] != 0));
+			int c3 = ((u[x + 3] != 0) & (s[x + 3] != 0));
+
+			h0[s[x] >> HISTOGRAM_SHIFT] += c0;
+			h1[s[x + 1] >> HISTOGRAM_SHIFT] += c1;
+			h2[s[x + 2] >> HISTOGRAM_SHIFT] += c2;
+			h3[s[x + 3] >> HISTOGRAM_SHIFT] += c3;
+
+			total += c0 + c1 + c2 + c3;
+		}
+
+		for (; x < xl; ++x)
+		{
+			int c = ((u[x] != 0) & (s[x] != 0));
+
+			h0[s[x] >> HISTOGRAM_SHIFT] += c;
+			total += c;
+		}
+	}
+
+	if (!total)
+		return;
+
+	// Blend into the histogram so far, and equalize: nearer is brighter
+	float* histogram = _depthHistogram.data();
+	QRgb* lookup = _depthLookup.data();
+	float k = HISTOGRAM_WEIGHT / total;
+	float sum = 0.0f;
+
+	for (int i = 0; i < HISTOGRAM_BINS; ++i)
+	{
+		int count = h0[i] + h1[i] + h2[i] + h3[i];
+		histogram[i] += (count * k) - (histogram[i] * HISTOGRAM_WEIGHT);
+		sum += histogram[i];
+
+		int n = 0xC0 * (1.0f - qMin(1.0f, sum));
+		lookup[i] = qRgba(n, n, n, 0xFF);
+	}
+}
+
+void SensorThread::onDepthMap()
+{
+	xn::DepthMetaData depthMetaData;
+	_depthGenerator.GetMetaData(depthMetaData);
+
+	xn::SceneMetaData sceneMetaData;
+	_userGenerator.GetUserPixels(0, sceneMetaData);
+
+	onDepthMap(depthMetaData.Data(), sceneMetaData.Data(), depthMetaData.XRes(), depthMetaData.YRes());
+}
+
+void SensorThread::onDepthMap(const XnDepthPixel* src, const XnLabel* usr, int xres, int yres)
+{
+	// Only convert the region occupied by users, scaled to the size it is displayed at
+	qreal scale = getAvatarScale(yres);
+	QSize size(qRound(xres * scale), qRound(yres * scale));
+
+	QRect rect = getUsersRect(usr, xres, yres);
+	if (rect.isEmpty())
+	{
+		// Unless the last users are still on their way
+		if (!_avatarPipeline->isBusy())
+			emit evUsersMap(QImage(), QPoint(), size);
+
+		return;
+	}
+
+	updateDepthHistogram(src, usr, xres, rect);
+
+	// Skip the frame if the previous one is still converting
+	if (_avatarPipeline->isBusy())
+		return;
+
+	rect = getAvatarRect(rect, scale);
+	initAvatarLookup(rect, scale, xres, yres);
+
+	_avatarPipeline->convert(src, usr, xres, _avatarRows, _avatarCols, _depthLookup, HISTOGRAM_SHIFT, rect, size);
+}
+
+void SensorThread::onImageMap()
+{
+	xn::ImageMetaData imageMetaData;
+	_imageGenerator.GetMetaData(imageMetaData);
+
+	xn::SceneMetaData sceneMetaData;
+	_userGenerator.GetUserPixels(0, sceneMetaData);
+
+	onImageMap(imageMetaData.RGB24Data(), sceneMetaData.Data(), imageMetaData.XRes(), imageMetaData.YRes());
+}
+
+void SensorThread::onImageMap(const XnRGB24Pixel* src, const XnLabel* usr, int xres, int yres)
+{
+	// Only convert the region occupied by users, scaled to the size it is displayed at
+	qreal scale = getAvatarScale(yres);
+	QSize size(qRound(xres * scale), qRound(yres * scale));
+
+	QRect rect = getUsersRect(usr, xres, yres);
+	if (rect.isEmpty())
+	{
+		// Unless the last users are still on their way
+		if (!_avatarPipeline->isBusy())
+			emit evUsersMap(QImage(), QPoint(), size);
+
+		return;
+	}
+
+	// Skip the frame if the previous one is still converting
+	if (_avatarPipeline->isBusy())
+		return;
+
+	rect = getAvatarRect(rect, scale);
+	initAvatarLookup(rect, scale, xres, yres);
+
+	_avatarPipeline->convert(src, usr, xres, _avatarRows, _avatarCols, rect, size);
+}
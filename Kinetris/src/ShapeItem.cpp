@@ -0,0 +1,114 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ShapeItem.h"
+
+#include "BlockAtlas.h"
+
+ShapeItem::ShapeItem(BlockAtlas* atlas, qreal block, QGraphicsItem* parent)
+	: QGraphicsItem(parent)
+	, _atlas(atlas)
+	, _block(block)
+	, _frame(0)
+	, _tint(0.0f)
+{
+}
+
+ShapeItem::~ShapeItem()
+{
+}
+
+int ShapeItem::getFrame() const
+{
+	return _frame;
+}
+
+void ShapeItem::setFrame(int frame)
+{
+	if (_frame == frame)
+		return;
+
+	_frame = frame;
+
+	updatePixmap();
+}
+
+QVector<Pair> ShapeItem::getShape() const
+{
+	return _shape;
+}
+
+void ShapeItem::setShape(const QVector<Pair>& shape)
+{
+	_shape = shape;
+
+	updatePixmap();
+}
+
+qreal ShapeItem::getTint() const
+{
+	return _tint;
+}
+
+void ShapeItem::setTint(qreal tint)
+{
+	if (_tint == tint)
+		return;
+
+	_tint = tint;
+
+	update();
+}
+
+QRectF ShapeItem::boundingRect() const
+{
+	return QRectF(0.0f, 0.0f, _block * 4, _block * 4);
+}
+
+void ShapeItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+	// Prevent "unreferenced formal parameter" warning
+	option;
+	widget;
+
+	painter->drawPixmap(0, 0, _pixmap);
+
+	// Fade the white silhouette over the piece, where a colorize effect would render offscreen
+	if (_tint > 0.0f)
+	{
+		qreal opacity = painter->opacity();
+		painter->setOpacity(opacity * _tint);
+		painter->drawPixmap(0, 0, _flash);
+		painter->setOpacity(opacity);
+	}
+}
+
+void ShapeItem::updatePixmap()
+{
+	// One prebaked pixmap per piece, rotation and size; swapping it is all a turn costs
+	_pixmap = _shape.isEmpty()
+		? QPixmap()
+		: _atlas->getShapePixmap(_frame, _shape, _block);
+	_flash = _shape.isEmpty()
+		? QPixmap()
+		: _atlas->getShapePixmap(BlockAtlas::FRAME_FLASH, _shape, _block);
+
+	update();
+}
@@ -0,0 +1,65 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KINETRIS_SHAPEITEM_H
+#define KINETRIS_SHAPEITEM_H
+
+#include <QtGui/QtGui>
+
+#include "Pair.h"
+
+class BlockAtlas;
+
+class ShapeItem : public QGraphicsItem
+{
+public:
+
+	ShapeItem(BlockAtlas* atlas, qreal block, QGraphicsItem* parent = NULL);
+	virtual ~ShapeItem();
+
+	int getFrame() const;
+	void setFrame(int frame);
+
+	QVector<Pair> getShape() const;
+	void setShape(const QVector<Pair>& shape);
+
+	qreal getTint() const;
+	void setTint(qreal tint);
+
+	virtual QRectF boundingRect() const;
+	virtual void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = NULL);
+
+protected:
+
+	BlockAtlas* _atlas;
+	qreal _block; // px
+
+	int _frame;
+	QVector<Pair> _shape;
+
+	qreal _tint;
+
+	QPixmap _pixmap;
+	QPixmap _flash;
+
+	void updatePixmap();
+};
+
+#endif // KINETRIS_SHAPEITEM_H
@@ -0,0 +1,307 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SyntheticSource.h"
+
+const SyntheticSource::Gesture SyntheticSource::GESTURES[] = {
+	{{0.0f, 0.0f, 0.0f}, 0.6f, {InputEvent::EVENT_NONE, {0.0f, 0.0f, 0.0f}}}, // Rest
+	{{-1.0f, 0.0f, 0.0f}, 0.4f, {InputEvent::EVENT_NONE, {0.0f, 0.0f, 0.0f}}}, // Move left
+	{{1.0f, 0.0f, 0.0f}, 0.4f, {InputEvent::EVENT_NONE, {0.0f, 0.0f, 0.0f}}}, // Move right
+	{{0.0f, -1.0f, 0.0f}, 0.3f, {InputEvent::EVENT_SWIPE_Y, {-1.0f, 1.0f, 0.0f}}}, // Drop
+	{{0.0f, 1.0f, 0.0f}, 0.3f, {InputEvent::EVENT_SWIPE_Y, {1.0f, 1.0f, 0.0f}}}, // Hold
+	{{0.0f, 0.0f, 1.0f}, 0.5f, {InputEvent::EVENT_CIRCLE, {-1.0f, 0.0f, 0.0f}}}, // Turn left
+	{{0.0f, 0.0f, 1.0f}, 0.5f, {InputEvent::EVENT_CIRCLE, {1.0f, 0.0f, 0.0f}}} // Turn right
+};
+const int SyntheticSource::GESTURE_COUNT = sizeof(GESTURES) / sizeof(GESTURES[0]);
+
+const qreal SyntheticSource::FRAME_INTERVAL = 1000.0f / 30.0f; // ms
+const qreal SyntheticSource::ROUND_DURATION = 30.0f; // sec
+
+const qreal SyntheticSource::HAND_RANGE = 200.0f; // mm
+const qreal SyntheticSource::HAND_SPEED = 10.0f; // 1/sec
+const qreal SyntheticSource::SLIDE_RANGE = 0.8f; // -1..1 of HAND_RANGE
+
+const int SyntheticSource::MAP_XRES = 640; // px
+const int SyntheticSource::MAP_YRES = 480; // px
+
+SyntheticSource::SyntheticSource(QObject* parent)
+	: InputSource(parent)
+{
+	init();
+}
+
+SyntheticSource::~SyntheticSource()
+{
+	setState(STATE_QUIT);
+
+	// Wait for run method to return
+	wait();
+}
+
+void SyntheticSource::init()
+{
+	_rate = 1.0f;
+
+	// Same gestures every run
+	_seed = 1;
+
+	_frame = 0;
+
+	initRound();
+	initState();
+}
+
+void SyntheticSource::initState()
+{
+	_state = STATE_NONE;
+	_s1 = STATE_NONE;
+}
+
+void SyntheticSource::initRound()
+{
+	_roundTime = 0.0f;
+
+	_gesture = 0;
+	_gestureTime = 0.0f;
+
+	_hand[0] = 0.0f;
+	_hand[1] = 0.0f;
+	_hand[2] = 0.0f;
+}
+
+SyntheticSource::State SyntheticSource::getState() const
+{
+	QMutexLocker l(&_stateMutex);
+
+	return _state;
+}
+
+void SyntheticSource::setState(State state)
+{
+	QMutexLocker l(&_stateMutex);
+
+	_s1 = state;
+}
+
+qreal SyntheticSource::getRate() const
+{
+	QMutexLocker l(&_configMutex);
+
+	return _rate;
+}
+
+void SyntheticSource::setRate(qreal rate)
+{
+	QMutexLocker l(&_configMutex);
+
+	_rate = rate;
+}
+
+void SyntheticSource::run()
+{
+	initState();
+
+	while (getState() != STATE_QUIT)
+	{
+		msleep(0);
+
+		update();
+	}
+}
+
+void SyntheticSource::update()
+{
+	State state = STATE_NONE;
+
+	{
+		QMutexLocker l(&_stateMutex);
+
+		if (_s1 != _state)
+		{
+			onStateLeave(_state);
+			_state = _s1;
+			onStateEnter(_state);
+		}
+
+		state = _state;
+	}
+
+	if (!state)
+	{
+		setState(STATE_CONNECT);
+	}
+	else if (state == STATE_CONNECT)
+	{
+		emit evConnectBegin();
+		emit evConnect();
+
+		dispatch(InputEvent::EVENT_USER_ENTER);
+		flush(0, QDateTime::currentMSecsSinceEpoch());
+
+		_frame = 0;
+		_timer.start();
+		_usersMapTimer.invalidate();
+
+		initRound();
+
+		setState(STATE_CAPTURE);
+	}
+	else if (state == STATE_CAPTURE)
+	{
+		// Pace frames like the sensor, scaled by rate, or as fast as possible if rate is 0
+		qreal rate = getRate();
+		if (rate > 0.0f)
+		{
+			qint64 t = (_frame * FRAME_INTERVAL / rate) - _timer.elapsed();
+			if (t > 0)
+				msleep(t);
+		}
+
+		++_frame;
+
+		qint64 captured = QDateTime::currentMSecsSinceEpoch();
+		qreal dt = FRAME_INTERVAL / 1000.0f;
+
+		updateRound(dt);
+		updateHand(dt);
+
+		flush(static_cast<quint64>(_frame * FRAME_INTERVAL * 1000.0f), captured);
+
+		// Unpaced, frames outrun the game; send the avatar no faster than the sensor
+		// would, rather than queue an image per frame for the game to catch up on
+		if ((getOutputs() & OUTPUT_AVATAR)
+			&& ((rate > 0.0f)
+				|| (!_usersMapTimer.isValid())
+				|| (_usersMapTimer.elapsed() >= FRAME_INTERVAL)))
+		{
+			_usersMapTimer.start();
+			updateUsersMap();
+		}
+	}
+	else if (state == STATE_QUIT)
+	{
+	}
+}
+
+void SyntheticSource::updateRound(qreal dt)
+{
+	if (!_roundTime)
+	{
+		dispatch(InputEvent::EVENT_SESSION_BEGIN);
+		dispatch(InputEvent::EVENT_FOCUS_GAIN);
+	}
+
+	_roundTime += dt;
+
+	if (_roundTime >= ROUND_DURATION)
+	{
+		// Start over if the game is over, otherwise pause and resume next round
+		dispatch(InputEvent::EVENT_WAVE);
+		dispatch(InputEvent::EVENT_FOCUS_LOSE);
+		dispatch(InputEvent::EVENT_SESSION_END);
+
+		initRound();
+		return;
+	}
+
+	_gestureTime += dt;
+
+	if (_gestureTime >= GESTURES[_gesture].duration)
+	{
+		dispatch(GESTURES[_gesture].event);
+
+		_gesture = random(GESTURE_COUNT);
+		_gestureTime = 0.0f;
+	}
+}
+
+void SyntheticSource::updateHand(qreal dt)
+{
+	// Ease towards where the current gesture wants the hand
+	const float* target = GESTURES[_gesture].hand;
+	qreal k = qMin<qreal>(1.0f, HAND_SPEED * dt);
+
+	for (int i = 0; i < 3; ++i)
+	{
+		_hand[i] += (target[i] - _hand[i]) * k;
+	}
+
+	HandPoint point = {static_cast<quint64>(_frame * FRAME_INTERVAL * 1000.0f), {_hand[0] * HAND_RANGE, _hand[1] * HAND_RANGE, _hand[2] * HAND_RANGE}};
+	publish(point);
+
+	dispatch(InputEvent::EVENT_SLIDE_X, qBound<qreal>(-1.0f, _hand[0] / SLIDE_RANGE, 1.0f));
+	dispatch(InputEvent::EVENT_SLIDE_Y, qBound<qreal>(-1.0f, _hand[1] / SLIDE_RANGE, 1.0f));
+	dispatch(InputEvent::EVENT_SLIDE_Z, qBound<qreal>(-1.0f, _hand[2] / SLIDE_RANGE, 1.0f));
+}
+
+void SyntheticSource::updateUsersMap()
+{
+	qreal scale = getAvatarScale(MAP_YRES);
+	QSize size(qRound(MAP_XRES * scale), qRound(MAP_YRES * scale));
+
+	// Region the figure can occupy, with the hand at full reach
+	QRect region(MAP_XRES / 2 - 240, 80, 480, MAP_YRES - 80);
+	QRect rect(QPoint(qFloor(region.left() * scale), qFloor(region.top() * scale)),
+		QPoint(qCeil((region.right() + 1) * scale) - 1, qCeil((region.bottom() + 1) * scale) - 1));
+
+	QImage usersMap(rect.size(), QImage::Format_ARGB32_Premultiplied);
+	usersMap.fill(0x00000000);
+
+	QPointF shoulder(MAP_XRES / 2 + 60, 220);
+	QPointF hand(MAP_XRES / 2 + 200 * _hand[0], 260 - 140 * _hand[1]);
+	QColor color = QColor::fromRgb(0x80, 0x80, 0x80, 0xFF);
+
+	QPainter painter(&usersMap);
+	painter.setRenderHint(QPainter::Antialiasing);
+	painter.translate(-rect.topLeft());
+	painter.scale(scale, scale);
+
+	painter.setPen(Qt::NoPen);
+	painter.setBrush(color);
+	painter.drawEllipse(QPointF(MAP_XRES / 2, 140), 40, 50); // Head
+	painter.drawRoundedRect(QRectF(MAP_XRES / 2 - 80, 200, 160, MAP_YRES - 200), 40, 40); // Body
+	painter.drawEllipse(hand, 30 - 10 * _hand[2], 30 - 10 * _hand[2]); // Hand, smaller when pulled back
+
+	painter.setPen(QPen(color, 40, Qt::SolidLine, Qt::RoundCap));
+	painter.drawLine(shoulder, hand); // Arm
+	painter.end();
+
+	emit evUsersMap(usersMap, rect.topLeft(), size);
+}
+
+int SyntheticSource::random(int count)
+{
+	// Own generator, since qrand() is seeded per thread
+	_seed = _seed * 1103515245 + 12345;
+
+	return ((_seed >> 16) & 0x7FFF) % count;
+}
+
+void SyntheticSource::onStateEnter(State state)
+{
+	// Prevent "unreferenced formal parameter" warning
+	state;
+}
+
+void SyntheticSource::onStateLeave(State state)
+{
+	// Prevent "unreferenced formal parameter" warning
+	state;
+}
@@ -0,0 +1,110 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KINETRIS_SYNTHETICSOURCE_H
+#define KINETRIS_SYNTHETICSOURCE_H
+
+#include <QtGui/QtGui>
+
+#include "InputSource.h"
+
+// Scripted hand that plays round after round of random gestures, at any rate,
+// for soak testing and profiling without a sensor
+class SyntheticSource : public InputSource
+{
+	Q_OBJECT
+
+public:
+
+	enum State
+	{
+		STATE_NONE = 0,
+		STATE_CONNECT,
+		STATE_CAPTURE,
+		STATE_QUIT
+	};
+
+	SyntheticSource(QObject* parent);
+	virtual ~SyntheticSource();
+
+	State getState() const;
+
+	qreal getRate() const;
+	void setRate(qreal rate);
+
+protected:
+
+	struct Gesture
+	{
+		float hand[3]; // -1..1 of HAND_RANGE
+		qreal duration; // sec
+		InputEvent event; // when hand arrives
+	};
+
+	static const Gesture GESTURES[];
+	static const int GESTURE_COUNT;
+
+	static const qreal FRAME_INTERVAL; // ms
+	static const qreal ROUND_DURATION; // sec
+
+	static const qreal HAND_RANGE; // mm
+	static const qreal HAND_SPEED; // 1/sec
+	static const qreal SLIDE_RANGE; // -1..1 of HAND_RANGE
+
+	static const int MAP_XRES; // px
+	static const int MAP_YRES; // px
+
+	State _state;
+	State _s1;
+	mutable QMutex _stateMutex;
+
+	qreal _rate;
+
+	quint32 _seed;
+
+	int _frame;
+	QElapsedTimer _timer;
+	QElapsedTimer _usersMapTimer; // since the avatar was last sent
+
+	qreal _roundTime; // sec
+	int _gesture;
+	qreal _gestureTime; // sec
+	float _hand[3]; // -1..1 of HAND_RANGE
+
+	void init();
+	void initState();
+	void initRound();
+	
+	void setState(State state);
+
+	void run();
+
+	void update();
+	void updateRound(qreal dt);
+	void updateHand(qreal dt);
+	void updateUsersMap();
+
+	int random(int count);
+
+	void onStateEnter(State state);
+	void onStateLeave(State state);
+};
+
+#endif // KINETRIS_SYNTHETICSOURCE_H
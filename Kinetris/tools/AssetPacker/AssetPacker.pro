@@ -0,0 +1,16 @@
+TEMPLATE = app
+
+TARGET = "AssetPacker"
+
+CONFIG += console
+CONFIG -= app_bundle
+
+QT += core \
+	gui
+
+INCLUDEPATH += "../../src"
+
+HEADERS += "../../src/AssetBundle.h"
+
+SOURCES += "../../src/AssetBundle.cpp" \
+	"main.cpp"
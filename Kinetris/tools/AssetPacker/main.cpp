@@ -0,0 +1,106 @@
+/**
+ * This file is part of Kinetris.
+ * 
+ * Kinetris ("this program") is Copyright (C) 2011 Conan Chen.
+ * Contact: Conan Chen <http://conanchen.com/>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtGui/QtGui>
+
+#include "AssetBundle.h"
+
+// Decodes every image listed in a .qrc file and writes them to a bundle
+// that LoaderThread maps instead of decoding the PNGs at startup.
+//
+// Usage: AssetPacker Kinetris.qrc Kinetris.pak
+
+int main(int argc, char* argv[])
+{
+	QCoreApplication app(argc, argv);
+
+	QStringList args = app.arguments();
+	if (args.count() != 3)
+	{
+		qWarning("Usage: AssetPacker <input.qrc> <output.pak>");
+		return 1;
+	}
+
+	QFile qrc(args[1]);
+	if (!qrc.open(QIODevice::ReadOnly))
+	{
+		qWarning("AssetPacker: cannot read %s", qPrintable(args[1]));
+		return 1;
+	}
+
+	QDir root = QFileInfo(qrc).absoluteDir();
+
+	QList<QPair<QString, QImage> > images;
+	QStringList sources;
+	QString prefix;
+
+	QXmlStreamReader xml(&qrc);
+	while (!xml.atEnd())
+	{
+		xml.readNext();
+
+		if (!xml.isStartElement())
+			continue;
+
+		if (xml.name() == QLatin1String("qresource"))
+		{
+			prefix = xml.attributes().value("prefix").toString();
+			if (!prefix.endsWith("/"))
+				prefix += "/";
+			if (!prefix.startsWith("/"))
+				prefix.prepend("/");
+		}
+		else if (xml.name() == QLatin1String("file"))
+		{
+			QString alias = xml.attributes().value("alias").toString();
+			QString file = xml.readElementText().trimmed();
+
+			QImageReader reader(root.filePath(file));
+			if (!reader.canRead())
+				continue;
+
+			QImage image = reader.read();
+			if (image.isNull())
+			{
+				qWarning("AssetPacker: cannot decode %s: %s", qPrintable(file), qPrintable(reader.errorString()));
+				return 1;
+			}
+
+			// The same URI the game passes to LoaderThread::getCachedPixmap
+			images << qMakePair(":" + prefix + (alias.isEmpty() ? file : alias), image);
+			sources << root.filePath(file);
+		}
+	}
+
+	if (xml.hasError())
+	{
+		qWarning("AssetPacker: %s: %s", qPrintable(args[1]), qPrintable(xml.errorString()));
+		return 1;
+	}
+
+	// The game hashes the same files out of its resources and ignores a bundle that differs
+	if (!AssetBundle::write(args[2], images, AssetBundle::getStamp(sources)))
+	{
+		qWarning("AssetPacker: cannot write %s", qPrintable(args[2]));
+		return 1;
+	}
+
+	return 0;
+}